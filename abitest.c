@@ -0,0 +1,93 @@
+/* C 接口的回归用例, 按 C 编译, 只链接 libhexcalc, 由 ctest 运行 */
+#include "hexcalc.h"
+#include <stdio.h>
+#include <string.h>
+
+static int g_failures = 0;
+
+#define EXPECT(cond) \
+    do { \
+        if (!(cond)){ \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++; \
+        } \
+    } while (0)
+
+static void set_job(hexcalc_job *job, const char *expr, char *out, size_t out_cap){
+    memset(job, 0, sizeof(*job));
+    job->expr = expr;
+    job->expr_len = strlen(expr);
+    job->out = out;
+    job->out_cap = out_cap;
+}
+
+static void test_batch(hexcalc_engine *engine){
+    char buf[3][64];
+    hexcalc_job jobs[3];
+    set_job(&jobs[0], "FF + 1", buf[0], sizeof(buf[0]));
+    set_job(&jobs[1], "1 / 0", buf[1], sizeof(buf[1]));
+    /* 截断时 out_len 仍是完整长度 */
+    set_job(&jobs[2], "FFFFFFFF", buf[2], 4);
+
+    EXPECT(hexcalc_eval_batch(engine, jobs, 3) == 1);
+    EXPECT(jobs[0].status == HEXCALC_OK && strcmp(buf[0], "100") == 0 && jobs[0].out_len == 3);
+    EXPECT(jobs[1].status == HEXCALC_ERROR && jobs[1].out_len > 0);
+    EXPECT(jobs[2].status == HEXCALC_OK && strcmp(buf[2], "FFF") == 0 && jobs[2].out_len == 8);
+}
+
+static void test_batch_ex(hexcalc_engine *engine){
+    char buf[2][64];
+    hexcalc_job jobs[2];
+    hexcalc_error errors[2];
+    set_job(&jobs[0], "2 ^ 10", buf[0], sizeof(buf[0]));
+    set_job(&jobs[1], "1 + 1 / 0", buf[1], sizeof(buf[1]));
+
+    EXPECT(hexcalc_eval_batch_ex(engine, jobs, errors, 2) == 1);
+    EXPECT(jobs[0].status == HEXCALC_OK && strcmp(buf[0], "10000") == 0);
+    EXPECT(errors[0].code == HEXCALC_ERR_NONE);
+    /* 失败时输出为空串, 位置指向 "/" */
+    EXPECT(jobs[1].status == HEXCALC_ERROR && buf[1][0] == '\0' && jobs[1].out_len == 0);
+    EXPECT(errors[1].code == HEXCALC_ERR_DIVISION_BY_ZERO && errors[1].offset == 6 && errors[1].length == 1);
+}
+
+static void test_error_message(hexcalc_engine *engine){
+    const char *expr = "1 $ 2";
+    char out[8];
+    char msg[128];
+    size_t len = 0;
+    hexcalc_error err;
+    EXPECT(hexcalc_eval_ex(engine, expr, strlen(expr), out, sizeof(out), &len, &err) == HEXCALC_ERROR);
+    EXPECT(err.code == HEXCALC_ERR_UNEXPECTED_CHAR && err.offset == 2 && err.length == 1);
+
+    const size_t full = hexcalc_error_message(&err, expr, strlen(expr), msg, sizeof(msg));
+    EXPECT(full > 0 && full == strlen(msg) && strstr(msg, "$") != NULL);
+    /* 与 snprintf 一样, 缓冲区不够时截断并返回完整长度 */
+    EXPECT(hexcalc_error_message(&err, expr, strlen(expr), out, sizeof(out)) == full && strlen(out) == sizeof(out) - 1);
+    EXPECT(hexcalc_error_message(&err, expr, strlen(expr), NULL, 0) == full);
+}
+
+static void test_arguments(hexcalc_engine *engine){
+    char out[8];
+    EXPECT(hexcalc_abi_version() == HEXCALC_ABI_VERSION);
+    EXPECT(hexcalc_eval(NULL, "1", 1, out, sizeof(out), NULL) == HEXCALC_INVALID_ARGUMENT);
+    EXPECT(hexcalc_set_backend(engine, 99) == HEXCALC_INVALID_ARGUMENT);
+    EXPECT(hexcalc_set_backend(engine, HEXCALC_BACKEND_FIXED64) == HEXCALC_OK);
+    EXPECT(hexcalc_eval(engine, "1 / 3", 5, out, sizeof(out), NULL) == HEXCALC_OK && strcmp(out, "0.55555") == 0);
+    EXPECT(hexcalc_set_backend(engine, HEXCALC_BACKEND_DOUBLE) == HEXCALC_OK);
+}
+
+int main(void){
+    hexcalc_engine *engine = hexcalc_create();
+    if (!engine){
+        fprintf(stderr, "hexcalc_create failed\n");
+        return 1;
+    }
+    test_batch(engine);
+    test_batch_ex(engine);
+    test_error_message(engine);
+    test_arguments(engine);
+    hexcalc_destroy(engine);
+
+    if (g_failures) fprintf(stderr, "%d failures\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// 性能测试: hexcalc_bench [scan] [modexp] [backends], 不带参数时运行全部
+// 只依赖 hexcalccore, 结果取多次运行中最快的一次
+#include "hexengine.h"
+#include "hexscan.h"
+#include "modarith.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 防止编译器把结果没被用到的计算整个删掉
+volatile std::uint64_t g_sink = 0;
+
+template <typename F>
+double bestSeconds(int reps, F &&f){
+    double best = 1e30;
+    for (int r = 0; r < reps; r++){
+        const auto t0 = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+        if (dt.count() < best) best = dt.count();
+    }
+    return best;
+}
+
+void printRate(const char *name, double bytes, double seconds){
+    std::printf("  %-28s %8.2f GB/s\n", name, bytes / seconds / 1e9);
+}
+
+// 十六进制数字的校验 / 转换: 标量实现与运行时选择的 SIMD 实现对比
+void benchScan(){
+    constexpr std::size_t kSize = 64u << 20;
+    static const char digits[] = "0123456789ABCDEF";
+    std::mt19937_64 rng(1);
+    std::string text(kSize, '0');
+    for (char &c : text) c = digits[rng() & 0xF];
+    std::vector<std::uint64_t> words(kSize / 16);
+
+    std::printf("scan: %zu MiB of hex digits, dispatched = %s\n", kSize >> 20, hexScanImplementation());
+    const double bytes = static_cast<double>(kSize);
+    printRate("hexRunLength scalar", bytes, bestSeconds(5, [&]{ g_sink += hexRunLengthScalar(text.data(), kSize); }));
+    printRate("hexRunLength dispatched", bytes, bestSeconds(5, [&]{ g_sink += hexRunLength(text.data(), kSize); }));
+    printRate("hexToWords scalar", bytes,
+              bestSeconds(5, [&]{ g_sink += hexToWordsScalar(text.data(), kSize, words.data()) + words[7]; }));
+    printRate("hexToWords dispatched", bytes,
+              bestSeconds(5, [&]{ g_sink += hexToWords(text.data(), kSize, words.data()) + words[7]; }));
+
+    // 整个解析路径: 一个很长的表达式 "N + N + ... + N", 数字为 8 / 40 个字符
+    for (const std::size_t len : { std::size_t(8), std::size_t(40) }){
+        std::string expr;
+        while (expr.size() < (16u << 20)){
+            if (!expr.empty()) expr += " + ";
+            expr.append(text, expr.size() % (kSize - len), len);
+        }
+        HexEngine engine;
+        std::string out;
+        const std::string name = "compute, " + std::to_string(len) + "-digit numbers";
+        if (!engine.compute(expr, out)){
+            std::printf("  %-28s failed: %s\n", name.c_str(), out.c_str());
+            continue;
+        }
+        printRate(name.c_str(), static_cast<double>(expr.size()),
+                  bestSeconds(3, [&]{ engine.compute(expr, out); g_sink += out.size(); }));
+    }
+}
+
+std::string randomHex(std::mt19937_64 &rng, std::size_t digitCount){
+    static const char digits[] = "0123456789ABCDEF";
+    std::string s(digitCount, '0');
+    for (char &c : s) c = digits[rng() & 0xF];
+    return s;
+}
+
+// 模幂: 奇数模 (Montgomery) 与同样长度的偶数模 (Barrett) 对比, 指数与模数同长
+void benchModexp(){
+    std::printf("modexp: full-length exponent, sliding window\n");
+    std::mt19937_64 rng(2);
+    for (const std::size_t bits : { 256, 512, 1024, 2048, 4096 }){
+        const std::size_t digitCount = bits / 4;
+        std::string modulus = randomHex(rng, digitCount);
+        modulus.front() = '8';
+        const std::string base = randomHex(rng, digitCount - 1);
+        const std::string exponent = randomHex(rng, digitCount);
+
+        std::vector<std::uint64_t> exp;
+        HexErrorCode code = HexErrorCode::None;
+        ModContext::parseHex(exponent, exp, code);
+
+        for (const char last : { '1', '0' }){
+            // 最低位决定模数奇偶, 也就决定了约简方式
+            modulus.back() = last;
+            ModContext ctx;
+            ctx.setModulus(modulus, code);
+            std::vector<std::uint64_t> a(ctx.limbs());
+            std::vector<std::uint64_t> r(ctx.limbs());
+            ctx.fromHex(base, a.data(), code);
+
+            const int reps = bits <= 1024 ? 200 : bits <= 2048 ? 20 : 4;
+            const double t = bestSeconds(3, [&]{
+                for (int i = 0; i < reps; i++) ctx.pow(a.data(), exp.data(), exp.size(), r.data());
+                g_sink += r[0];
+            }) / reps;
+            std::printf("  %4zu-bit %-10s %10.3f ms %10.1f ops/s\n", bits, ctx.isMontgomery() ? "montgomery" : "barrett",
+                        t * 1e3, 1.0 / t);
+        }
+    }
+}
+
+// 数值后端的速度和精度. 参考值由精确的有理数运算得到, 截断到 28 位小数
+struct Reference {
+    const char *expr;
+    const char *value;
+};
+const Reference kReferences[] = {
+    { "1 / 3", "0.5555555555555555555555555555" },
+    { "1 / 7 + 1 / B", "0.3BD81A98EF606A63BD81A98EF606" },
+    { "(1 + 1 / 186A0) ^ 186A0", "2.B7E06D5C6B856B6308C15530F3DF" },
+    { "A.8 / 3.3 - 1.1 / 7", "3.246FDD946FDD946FDD946FDD946F" },
+    { "1234.5678 * 9.ABC / 11", "A5B.27F4698787878787878787878787" },
+    { "(3 / 7) ^ 14 * 10000000", "B.BAEC2F508656A0EEC9042A69F758" }
+};
+
+// 与参考值一致的小数位数; 输出去掉了结尾的 0, 按 0 补齐再比较
+int correctFracDigits(const std::string &out, const char *ref){
+    const std::size_t dot = std::strchr(ref, '.') - ref;
+    if (out.compare(0, dot, ref, dot) != 0 || (out.size() > dot && out[dot] != '.')) return 0;
+    int n = 0;
+    for (std::size_t i = dot + 1; ref[i]; i++){
+        const char c = i < out.size() ? out[i] : '0';
+        if (c != ref[i]) break;
+        n++;
+    }
+    return n;
+}
+
+void benchBackends(){
+    const HexEngine::Backend backends[] = { HexEngine::Backend::Double, HexEngine::Backend::LongDouble,
+                                            HexEngine::Backend::Float128, HexEngine::Backend::Fixed64 };
+    std::printf("backends: correct fraction digits (shown digits are capped per backend), time per compute()\n");
+    std::printf("  %-26s", "");
+    for (const HexEngine::Backend b : backends){
+        if (HexEngine::backendAvailable(b)) std::printf(" %11s", HexEngine::backendName(b));
+    }
+    std::printf("\n");
+
+    HexEngine engine;
+    std::string out;
+    for (const Reference &r : kReferences){
+        std::printf("  %-26s", r.expr);
+        for (const HexEngine::Backend b : backends){
+            if (!HexEngine::backendAvailable(b)) continue;
+            engine.setBackend(b);
+            engine.compute(r.expr, out);
+            std::printf(" %11d", correctFracDigits(out, r.value));
+        }
+        std::printf("\n");
+    }
+
+    std::printf("  %-26s", "ns per compute()");
+    for (const HexEngine::Backend b : backends){
+        if (!HexEngine::backendAvailable(b)) continue;
+        engine.setBackend(b);
+        constexpr int kReps = 2000;
+        const double t = bestSeconds(3, [&]{
+            for (int i = 0; i < kReps; i++){
+                for (const Reference &r : kReferences){
+                    engine.compute(r.expr, out);
+                    g_sink += out.size();
+                }
+            }
+        });
+        std::printf(" %11.0f", t * 1e9 / (kReps * (sizeof(kReferences) / sizeof(kReferences[0]))));
+    }
+    std::printf("\n");
+}
+
+struct Section {
+    const char *name;
+    void (*run)();
+};
+const Section kSections[] = {
+    { "scan", benchScan },
+    { "modexp", benchModexp },
+    { "backends", benchBackends }
+};
+
+} // namespace
+
+int main(int argc, char *argv[]){
+    for (const Section &s : kSections){
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++){
+            if (!std::strcmp(argv[i], s.name)) selected = true;
+        }
+        if (selected) s.run();
+    }
+    return 0;
+}
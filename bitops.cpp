@@ -0,0 +1,278 @@
+#include "bitops.h"
+#include "cpufeatures.h"
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BITOPS_X86 1
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BITOPS_TARGET(t) __attribute__((target(t)))
+#else
+#define BITOPS_TARGET(t)
+#endif
+
+namespace {
+
+// 可移植实现
+
+int popcountPortable(std::uint64_t x){
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+}
+
+int clzPortable(std::uint64_t x){
+    if (x == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return 63 - static_cast<int>(idx);
+#else
+    int n = 0;
+    while (!(x & (1ull << 63))){
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+int ctzPortable(std::uint64_t x){
+    if (x == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<int>(idx);
+#else
+    int n = 0;
+    while (!(x & 1)){
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+std::uint64_t pextPortable(std::uint64_t x, std::uint64_t mask){
+    std::uint64_t r = 0;
+    for (std::uint64_t bit = 1; mask; bit <<= 1){
+        const std::uint64_t low = mask & (0 - mask);
+        if (x & low) r |= bit;
+        mask &= mask - 1;
+    }
+    return r;
+}
+
+std::uint64_t pdepPortable(std::uint64_t x, std::uint64_t mask){
+    std::uint64_t r = 0;
+    for (std::uint64_t bit = 1; mask; bit <<= 1){
+        const std::uint64_t low = mask & (0 - mask);
+        if (x & bit) r |= low;
+        mask &= mask - 1;
+    }
+    return r;
+}
+
+// 整块版本: 单个字的实现在这里内联展开, 整个循环只经过一次函数指针
+#define BITOPS_UNARY_BLOCK(name, fn) \
+    void name(const std::uint64_t *x, std::uint64_t *out, std::size_t n){ \
+        for (std::size_t i = 0; i < n; i++) out[i] = static_cast<std::uint64_t>(fn(x[i])); \
+    }
+#define BITOPS_BINARY_BLOCK(name, fn) \
+    void name(const std::uint64_t *x, const std::uint64_t *mask, std::uint64_t *out, std::size_t n){ \
+        for (std::size_t i = 0; i < n; i++) out[i] = fn(x[i], mask[i]); \
+    }
+
+BITOPS_UNARY_BLOCK(popcountBlockPortable, popcountPortable)
+BITOPS_UNARY_BLOCK(clzBlockPortable, clzPortable)
+BITOPS_UNARY_BLOCK(ctzBlockPortable, ctzPortable)
+BITOPS_BINARY_BLOCK(pextBlockPortable, pextPortable)
+BITOPS_BINARY_BLOCK(pdepBlockPortable, pdepPortable)
+
+#ifdef BITOPS_X86
+
+BITOPS_TARGET("popcnt")
+int popcountHw(std::uint64_t x){
+    return static_cast<int>(_mm_popcnt_u64(x));
+}
+
+BITOPS_TARGET("lzcnt")
+int clzHw(std::uint64_t x){
+    return static_cast<int>(_lzcnt_u64(x));
+}
+
+BITOPS_TARGET("bmi")
+int ctzHw(std::uint64_t x){
+    return static_cast<int>(_tzcnt_u64(x));
+}
+
+BITOPS_TARGET("bmi2")
+std::uint64_t pextHw(std::uint64_t x, std::uint64_t mask){
+    return _pext_u64(x, mask);
+}
+
+BITOPS_TARGET("bmi2")
+std::uint64_t pdepHw(std::uint64_t x, std::uint64_t mask){
+    return _pdep_u64(x, mask);
+}
+
+BITOPS_TARGET("popcnt") BITOPS_UNARY_BLOCK(popcountBlockHw, popcountHw)
+BITOPS_TARGET("lzcnt") BITOPS_UNARY_BLOCK(clzBlockHw, clzHw)
+BITOPS_TARGET("bmi") BITOPS_UNARY_BLOCK(ctzBlockHw, ctzHw)
+BITOPS_TARGET("bmi2") BITOPS_BINARY_BLOCK(pextBlockHw, pextHw)
+BITOPS_TARGET("bmi2") BITOPS_BINARY_BLOCK(pdepBlockHw, pdepHw)
+
+// 单独的循环版本, 避免每 8 个字节都经过一次函数指针
+BITOPS_TARGET("popcnt")
+std::uint64_t popcountBytesHw(const std::uint8_t *p, std::size_t n){
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        std::uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        total += _mm_popcnt_u64(w);
+    }
+    for (; i < n; i++) total += _mm_popcnt_u64(p[i]);
+    return total;
+}
+
+#endif // BITOPS_X86
+
+std::uint64_t popcountBytesPortable(const std::uint8_t *p, std::size_t n){
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        std::uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        total += static_cast<std::uint64_t>(popcountPortable(w));
+    }
+    for (; i < n; i++) total += static_cast<std::uint64_t>(popcountPortable(p[i]));
+    return total;
+}
+
+struct Kernels {
+    int (*popcount)(std::uint64_t);
+    int (*clz)(std::uint64_t);
+    int (*ctz)(std::uint64_t);
+    std::uint64_t (*pext)(std::uint64_t, std::uint64_t);
+    std::uint64_t (*pdep)(std::uint64_t, std::uint64_t);
+    std::uint64_t (*popcountBytes)(const std::uint8_t *, std::size_t);
+    void (*popcountBlock)(const std::uint64_t *, std::uint64_t *, std::size_t);
+    void (*clzBlock)(const std::uint64_t *, std::uint64_t *, std::size_t);
+    void (*ctzBlock)(const std::uint64_t *, std::uint64_t *, std::size_t);
+    void (*pextBlock)(const std::uint64_t *, const std::uint64_t *, std::uint64_t *, std::size_t);
+    void (*pdepBlock)(const std::uint64_t *, const std::uint64_t *, std::uint64_t *, std::size_t);
+    std::string name;
+};
+
+Kernels selectKernels(){
+    Kernels k { popcountPortable, clzPortable, ctzPortable, pextPortable, pdepPortable,
+                popcountBytesPortable, popcountBlockPortable, clzBlockPortable, ctzBlockPortable,
+                pextBlockPortable, pdepBlockPortable, std::string() };
+#ifdef BITOPS_X86
+    auto use = [&k](const char *feature){
+        if (!k.name.empty()) k.name += ' ';
+        k.name += feature;
+    };
+    if (cpuHasPopcnt()){
+        k.popcount = popcountHw;
+        k.popcountBytes = popcountBytesHw;
+        k.popcountBlock = popcountBlockHw;
+        use("popcnt");
+    }
+    if (cpuHasLzcnt()){
+        k.clz = clzHw;
+        k.clzBlock = clzBlockHw;
+        use("lzcnt");
+    }
+    if (cpuHasBmi1()){
+        k.ctz = ctzHw;
+        k.ctzBlock = ctzBlockHw;
+        use("bmi1");
+    }
+    if (cpuHasBmi2()){
+        k.pext = pextHw;
+        k.pdep = pdepHw;
+        k.pextBlock = pextBlockHw;
+        k.pdepBlock = pdepBlockHw;
+        use("bmi2");
+    }
+#endif
+    if (k.name.empty()) k.name = "portable";
+    return k;
+}
+
+const Kernels &kernels(){
+    static const Kernels k = selectKernels();
+    return k;
+}
+
+} // namespace
+
+int bitPopcount(std::uint64_t x){
+    return kernels().popcount(x);
+}
+
+int bitClz(std::uint64_t x){
+    return kernels().clz(x);
+}
+
+int bitCtz(std::uint64_t x){
+    return kernels().ctz(x);
+}
+
+int bitParity(std::uint64_t x){
+    return kernels().popcount(x) & 1;
+}
+
+std::uint64_t bitPext(std::uint64_t x, std::uint64_t mask){
+    return kernels().pext(x, mask);
+}
+
+std::uint64_t bitPdep(std::uint64_t x, std::uint64_t mask){
+    return kernels().pdep(x, mask);
+}
+
+void bitPopcountBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n){
+    kernels().popcountBlock(x, out, n);
+}
+
+void bitClzBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n){
+    kernels().clzBlock(x, out, n);
+}
+
+void bitCtzBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n){
+    kernels().ctzBlock(x, out, n);
+}
+
+void bitParityBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n){
+    kernels().popcountBlock(x, out, n);
+    for (std::size_t i = 0; i < n; i++) out[i] &= 1;
+}
+
+void bitPextBlock(const std::uint64_t *x, const std::uint64_t *mask, std::uint64_t *out, std::size_t n){
+    kernels().pextBlock(x, mask, out, n);
+}
+
+void bitPdepBlock(const std::uint64_t *x, const std::uint64_t *mask, std::uint64_t *out, std::size_t n){
+    kernels().pdepBlock(x, mask, out, n);
+}
+
+std::uint64_t bytesPopcount(const std::uint8_t *p, std::size_t n){
+    return kernels().popcountBytes(p, n);
+}
+
+const char *bitOpsImplementation(){
+    return kernels().name.c_str();
+}
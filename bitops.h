@@ -0,0 +1,68 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+// 64 位字上的位操作
+// popcount / clz / ctz / pext / pdep 运行时按 CPU 选择 POPCNT / LZCNT / BMI1 / BMI2 指令,
+// 不支持时用可移植实现; 其余操作写成内联函数, 编译器本身就能生成对应指令
+
+int bitPopcount(std::uint64_t x);
+// x 为 0 时返回 64
+int bitClz(std::uint64_t x);
+int bitCtz(std::uint64_t x);
+int bitParity(std::uint64_t x);
+// 按 mask 中为 1 的位抽取 / 分散, 低位在前
+std::uint64_t bitPext(std::uint64_t x, std::uint64_t mask);
+std::uint64_t bitPdep(std::uint64_t x, std::uint64_t mask);
+
+// 对 n 个字逐个计算, 每次调用只选择一次实现, 循环内没有间接调用; out 可以与输入是同一块内存
+void bitPopcountBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n);
+void bitClzBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n);
+void bitCtzBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n);
+void bitParityBlock(const std::uint64_t *x, std::uint64_t *out, std::size_t n);
+void bitPextBlock(const std::uint64_t *x, const std::uint64_t *mask, std::uint64_t *out, std::size_t n);
+void bitPdepBlock(const std::uint64_t *x, const std::uint64_t *mask, std::uint64_t *out, std::size_t n);
+
+// 移位数按 64 取模
+inline std::uint64_t bitRol(std::uint64_t x, unsigned n){
+    n &= 63;
+    return n ? (x << n) | (x >> (64 - n)) : x;
+}
+
+inline std::uint64_t bitRor(std::uint64_t x, unsigned n){
+    n &= 63;
+    return n ? (x >> n) | (x << (64 - n)) : x;
+}
+
+inline std::uint64_t bitBswap(std::uint64_t x){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(x);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(x);
+#else
+    x = ((x & 0x00FF00FF00FF00FFull) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFull);
+    x = ((x & 0x0000FFFF0000FFFFull) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFull);
+    return (x << 32) | (x >> 32);
+#endif
+}
+
+inline std::uint64_t bitReverse(std::uint64_t x){
+    // 先在每个字节内翻转, 再翻转字节顺序
+    x = ((x & 0x5555555555555555ull) << 1) | ((x >> 1) & 0x5555555555555555ull);
+    x = ((x & 0x3333333333333333ull) << 2) | ((x >> 2) & 0x3333333333333333ull);
+    x = ((x & 0x0F0F0F0F0F0F0F0Full) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0Full);
+    return bitBswap(x);
+}
+
+// 字节数组中为 1 的位数
+std::uint64_t bytesPopcount(const std::uint8_t *p, std::size_t n);
+
+// 当前使用的实现, 例如 "popcnt lzcnt bmi1 bmi2" / "portable"
+const char *bitOpsImplementation();
+
+#endif // BITOPS_H
@@ -0,0 +1,304 @@
+#include "byteexpr.h"
+#include "bitops.h"
+#include "bytekernels.h"
+#include "hexscan.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 分块写出时每块的大小
+constexpr std::int64_t kChunkSize = 1 << 20;
+
+} // namespace
+
+ByteExpr::ByteExpr(Kind kind)
+    : m_kind(kind)
+{
+}
+
+ByteExpr::~ByteExpr() = default;
+
+ByteExpr::Ptr ByteExpr::fromHex(std::string_view digits, HexErrorCode &err){
+    if (digits.empty()){
+        err = HexErrorCode::EmptyByteLiteral;
+        return nullptr;
+    }
+    std::string padded;
+    if (digits.size() % 2){
+        padded.reserve(digits.size() + 1);
+        padded += '0';
+        padded += digits;
+        digits = padded;
+    }
+
+    const std::size_t n = digits.size();
+    std::vector<std::uint8_t> bytes(n / 2);
+    const char *p = digits.data();
+    std::uint8_t *o = bytes.data();
+
+    // 16 个字符一组批量转换, 剩下的逐字节处理
+    std::size_t done = 0;
+    std::uint64_t words[32];
+    while (n - done >= 16){
+        const std::size_t chunk = std::min<std::size_t>((n - done) / 16, 32) * 16;
+        const std::size_t count = hexToWords(p + done, chunk, words);
+        for (std::size_t k = 0; k < count; k++){
+            for (int b = 0; b < 8; b++){
+                o[done / 2 + k * 8 + b] = static_cast<std::uint8_t>(words[k] >> (56 - 8 * b));
+            }
+        }
+        if (count * 16 != chunk){
+            err = HexErrorCode::InvalidByteLiteral;
+            return nullptr;
+        }
+        done += chunk;
+    }
+    for (; done < n; done += 2){
+        std::uint64_t w = 0;
+        if (!hexToWord(p + done, 2, w)){
+            err = HexErrorCode::InvalidByteLiteral;
+            return nullptr;
+        }
+        o[done / 2] = static_cast<std::uint8_t>(w);
+    }
+
+    std::shared_ptr<ByteExpr> e(new ByteExpr(Kind::Literal));
+    e->m_size = static_cast<std::int64_t>(bytes.size());
+    e->m_bytes = std::move(bytes);
+    return e;
+}
+
+ByteExpr::Ptr ByteExpr::mapFile(const std::string &path, HexErrorCode &err){
+    std::shared_ptr<ByteExpr> e(new ByteExpr(Kind::File));
+    if (!e->m_file.open(path, err)) return nullptr;
+    e->m_size = e->m_file.size();
+    return e;
+}
+
+ByteExpr::Ptr ByteExpr::broadcast(std::uint8_t byte){
+    std::shared_ptr<ByteExpr> e(new ByteExpr(Kind::Broadcast));
+    e->m_size = -1;
+    e->m_fill = byte;
+    return e;
+}
+
+ByteExpr::Ptr ByteExpr::complement(const Ptr &a){
+    std::shared_ptr<ByteExpr> e(new ByteExpr(Kind::Not));
+    e->m_size = a->size();
+    e->m_a = a;
+    return e;
+}
+
+ByteExpr::Ptr ByteExpr::combine(Kind op, const Ptr &a, const Ptr &b){
+    std::shared_ptr<ByteExpr> e(new ByteExpr(op));
+    e->m_size = std::max(a->size(), b->size());
+    e->m_a = a;
+    e->m_b = b;
+    return e;
+}
+
+ByteExpr::Ptr ByteExpr::shift(Kind op, const Ptr &a, std::int64_t bits){
+    std::shared_ptr<ByteExpr> e(new ByteExpr(op));
+    e->m_size = a->size();
+    e->m_a = a;
+    e->m_bits = bits;
+    return e;
+}
+
+ByteExpr::Ptr ByteExpr::rotate(Kind op, const Ptr &a, std::int64_t bits){
+    // 由两次移位拼成: a << k | a >> (n - k)
+    const std::int64_t total = a->size() * 8;
+    if (total <= 0) return a;
+    std::int64_t k = bits % total;
+    if (k < 0) k += total;
+    if (k == 0) return a;
+    const Kind other = op == Kind::Shl ? Kind::Shr : Kind::Shl;
+    return combine(Kind::Or, shift(op, a, k), shift(other, a, total - k));
+}
+
+ByteExpr::Ptr ByteExpr::reverse(Kind op, const Ptr &a){
+    std::shared_ptr<ByteExpr> e(new ByteExpr(op));
+    e->m_size = a->size();
+    e->m_a = a;
+    return e;
+}
+
+void ByteExpr::read(std::int64_t offset, std::int64_t len, std::uint8_t *out) const{
+    if (len <= 0) return;
+    std::vector<std::uint8_t> scratch(scratchSize(len));
+    read(offset, len, out, scratch.data());
+}
+
+std::size_t ByteExpr::scratchSize(std::int64_t len) const{
+    const std::size_t n = static_cast<std::size_t>(len);
+    switch (m_kind){
+    case Kind::Literal:
+    case Kind::File:
+    case Kind::Broadcast:
+        return 0;
+    case Kind::Not:
+    case Kind::Reverse:
+    case Kind::BitReverse:
+        return m_a->scratchSize(len);
+    case Kind::And:
+    case Kind::Or:
+    case Kind::Xor:
+        // 左边读完以后右边的数据才占用前 n 个字节
+        return std::max(m_a->scratchSize(len), n + m_b->scratchSize(len));
+    case Kind::Shl:
+    case Kind::Shr:
+        if (m_bits % 8 == 0) return m_a->scratchSize(len);
+        return n + 1 + m_a->scratchSize(len + 1);
+    }
+    return 0;
+}
+
+void ByteExpr::read(std::int64_t offset, std::int64_t len, std::uint8_t *out, std::uint8_t *scratch) const{
+    if (len <= 0) return;
+    if (m_size < 0){
+        readInRange(offset, len, out, scratch);
+        return;
+    }
+
+    const std::int64_t lead = offset < 0 ? std::min(len, -offset) : 0;
+    const std::int64_t begin = offset + lead;
+    const std::int64_t avail = std::max<std::int64_t>(0, std::min(offset + len, m_size) - begin);
+
+    std::memset(out, 0, static_cast<std::size_t>(lead));
+    if (avail > 0) readInRange(begin, avail, out + lead, scratch);
+    std::memset(out + lead + avail, 0, static_cast<std::size_t>(len - lead - avail));
+}
+
+void ByteExpr::readInRange(std::int64_t offset, std::int64_t len, std::uint8_t *out, std::uint8_t *scratch) const{
+    const std::size_t n = static_cast<std::size_t>(len);
+
+    switch (m_kind){
+    case Kind::Literal:
+        std::memcpy(out, m_bytes.data() + offset, n);
+        return;
+    case Kind::File:
+        std::memcpy(out, m_file.data() + offset, n);
+        return;
+    case Kind::Broadcast:
+        std::memset(out, m_fill, n);
+        return;
+    case Kind::Not:
+        m_a->read(offset, len, out, scratch);
+        bytesNot(out, n);
+        return;
+    case Kind::And:
+    case Kind::Or:
+    case Kind::Xor: {
+        m_a->read(offset, len, out, scratch);
+        std::uint8_t *rhs = scratch;
+        m_b->read(offset, len, rhs, scratch + n);
+        if (m_kind == Kind::And) bytesAnd(out, rhs, n);
+        else if (m_kind == Kind::Or) bytesOr(out, rhs, n);
+        else bytesXor(out, rhs, n);
+        return;
+    }
+    case Kind::Reverse:
+    case Kind::BitReverse: {
+        // out[i] = src[size - 1 - i]
+        m_a->read(m_size - offset - len, len, out, scratch);
+        std::reverse(out, out + n);
+        if (m_kind == Kind::BitReverse){
+            for (std::size_t i = 0; i < n; i++) out[i] = static_cast<std::uint8_t>(bitReverse(out[i]) >> 56);
+        }
+        return;
+    }
+    case Kind::Shl:
+    case Kind::Shr: {
+        // 左移: out[i] = src[i + k] << b | src[i + k + 1] >> (8 - b)
+        // 右移: out[i] = src[i - k - 1] << (8 - b) | src[i - k] >> b
+        const std::int64_t k = m_bits / 8;
+        const int b = static_cast<int>(m_bits % 8);
+        const std::int64_t srcOffset = m_kind == Kind::Shl ? offset + k : offset - k;
+        if (b == 0){
+            m_a->read(srcOffset, len, out, scratch);
+            return;
+        }
+        std::uint8_t *src = scratch;
+        if (m_kind == Kind::Shl){
+            m_a->read(srcOffset, len + 1, src, scratch + n + 1);
+            bytesFunnelShift(out, src, n, b);
+        } else {
+            m_a->read(srcOffset - 1, len + 1, src, scratch + n + 1);
+            bytesFunnelShift(out, src, n, 8 - b);
+        }
+        return;
+    }
+    }
+}
+
+bool ByteExpr::forEachChunk(const Sink &fn) const{
+    const std::int64_t chunkSize = std::min(std::max<std::int64_t>(m_size, 0), kChunkSize);
+    std::vector<std::uint8_t> chunk(static_cast<std::size_t>(chunkSize));
+    // 所有块共用一块临时空间
+    std::vector<std::uint8_t> scratch(scratchSize(chunkSize));
+    for (std::int64_t offset = 0; offset < m_size; offset += kChunkSize){
+        const std::int64_t len = std::min(kChunkSize, m_size - offset);
+        read(offset, len, chunk.data(), scratch.data());
+        if (!fn(chunk.data(), static_cast<std::size_t>(len))) return false;
+    }
+    return true;
+}
+
+bool ByteExpr::writeTo(const Sink &sink) const{
+    return forEachChunk(sink);
+}
+
+std::uint64_t ByteExpr::popcount() const{
+    std::uint64_t total = 0;
+    forEachChunk([&total](const std::uint8_t *data, std::size_t len){
+        total += bytesPopcount(data, len);
+        return true;
+    });
+    return total;
+}
+
+std::uint64_t ByteExpr::leadingZeros() const{
+    // 第 0 字节为最高位, 找到第一个非零字节即可结束
+    std::uint64_t zeros = 0;
+    forEachChunk([&zeros](const std::uint8_t *data, std::size_t len){
+        for (std::size_t i = 0; i < len; i++){
+            if (data[i]){
+                zeros += static_cast<std::uint64_t>(bitClz(data[i]) - 56);
+                return false;
+            }
+            zeros += 8;
+        }
+        return true;
+    });
+    return zeros;
+}
+
+std::uint64_t ByteExpr::trailingZeros() const{
+    std::uint64_t zeros = 0;
+    forEachChunk([&zeros](const std::uint8_t *data, std::size_t len){
+        for (std::size_t i = 0; i < len; i++){
+            zeros = data[i] ? static_cast<std::uint64_t>(bitCtz(data[i])) : zeros + 8;
+        }
+        return true;
+    });
+    return zeros;
+}
+
+void ByteExpr::appendHexPreview(std::int64_t maxBytes, std::string &out) const{
+    static const char digits[] = "0123456789ABCDEF";
+    const std::int64_t shown = std::min(std::max<std::int64_t>(m_size, 0), maxBytes);
+    std::vector<std::uint8_t> head(static_cast<std::size_t>(shown));
+    read(0, shown, head.data());
+
+    out += '#';
+    for (std::uint8_t b : head){
+        out += digits[b >> 4];
+        out += digits[b & 0xF];
+    }
+    if (shown < m_size){
+        out += "... (";
+        out += std::to_string(m_size);
+        out += " bytes)";
+    }
+}
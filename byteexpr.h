@@ -0,0 +1,90 @@
+#ifndef BYTEEXPR_H
+#define BYTEEXPR_H
+
+#include "mappedfile.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 字节数组表达式
+// 叶子是字节字面量 (#DEADBEEF) 或内存映射的文件 ("path"), 内部节点是按位运算
+// 按字节位置对齐 (第 0 字节为最高位), 较短的一方在末尾补零
+// 按区间惰性求值, 结果可以分块写出, 不需要整个放进内存
+class ByteExpr
+{
+public:
+    using Ptr = std::shared_ptr<const ByteExpr>;
+
+    enum class Kind {
+        Literal,
+        File,
+        Broadcast,
+        Not,
+        And,
+        Or,
+        Xor,
+        Shl,
+        Shr,
+        Reverse,        // 字节顺序颠倒
+        BitReverse      // 整段按位颠倒
+    };
+
+    // 分块输出, 返回 false 表示写入失败
+    using Sink = std::function<bool(const std::uint8_t *data, std::size_t len)>;
+
+    // 失败时返回 nullptr, 错误码写入 err
+    static Ptr fromHex(std::string_view digits, HexErrorCode &err);
+    static Ptr mapFile(const std::string &path, HexErrorCode &err);
+    // 每个字节都是 byte, 没有固定长度
+    static Ptr broadcast(std::uint8_t byte);
+    static Ptr complement(const Ptr &a);
+    static Ptr combine(Kind op, const Ptr &a, const Ptr &b);
+    // 整段移位, 长度不变, 移出的位丢弃
+    static Ptr shift(Kind op, const Ptr &a, std::int64_t bits);
+    // 整段循环移位, op 为 Shl / Shr, 位数按总位数取模
+    static Ptr rotate(Kind op, const Ptr &a, std::int64_t bits);
+    // op 为 Reverse / BitReverse
+    static Ptr reverse(Kind op, const Ptr &a);
+
+    ~ByteExpr();
+
+    // 字节数, 广播常量返回 -1
+    std::int64_t size() const { return m_size; }
+
+    // 读取 [offset, offset + len), 超出 [0, size) 的部分为 0
+    void read(std::int64_t offset, std::int64_t len, std::uint8_t *out) const;
+
+    // 整段的位计数, 全 0 时 leadingZeros / trailingZeros 为 size() * 8
+    std::uint64_t popcount() const;
+    std::uint64_t leadingZeros() const;
+    std::uint64_t trailingZeros() const;
+
+    // sink 返回 false 时停止并返回 false
+    bool writeTo(const Sink &sink) const;
+    // "#" 加前 maxBytes 个字节的十六进制, 更长时附带总字节数, 追加到 out
+    void appendHexPreview(std::int64_t maxBytes, std::string &out) const;
+
+private:
+    explicit ByteExpr(Kind kind);
+
+    // scratch 由调用方提供, 至少 scratchSize(len) 字节; 各层节点的临时数据依次放在里面, 读取时不分配内存
+    void read(std::int64_t offset, std::int64_t len, std::uint8_t *out, std::uint8_t *scratch) const;
+    void readInRange(std::int64_t offset, std::int64_t len, std::uint8_t *out, std::uint8_t *scratch) const;
+    std::size_t scratchSize(std::int64_t len) const;
+    // 按块顺序读出整段, fn 返回 false 时提前结束并返回 false
+    bool forEachChunk(const Sink &fn) const;
+
+    Kind m_kind;
+    std::int64_t m_size = 0;
+    std::vector<std::uint8_t> m_bytes;
+    MappedFile m_file;
+    std::uint8_t m_fill = 0;
+    Ptr m_a;
+    Ptr m_b;
+    std::int64_t m_bits = 0;
+};
+
+#endif // BYTEEXPR_H
@@ -0,0 +1,183 @@
+#include "bytekernels.h"
+#include "cpufeatures.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BYTEKERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BYTEKERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BYTEKERNELS_TARGET_AVX2
+#endif
+
+namespace {
+
+enum class BitOp { And, Or, Xor };
+
+template <BitOp op>
+std::uint8_t apply(std::uint8_t a, std::uint8_t b){
+    if (op == BitOp::And) return a & b;
+    if (op == BitOp::Or) return a | b;
+    return a ^ b;
+}
+
+template <BitOp op>
+void binaryScalar(std::uint8_t *dst, const std::uint8_t *src, std::size_t n){
+    for (std::size_t i = 0; i < n; i++) dst[i] = apply<op>(dst[i], src[i]);
+}
+
+void notScalar(std::uint8_t *dst, std::size_t n){
+    for (std::size_t i = 0; i < n; i++) dst[i] = static_cast<std::uint8_t>(~dst[i]);
+}
+
+void funnelScalar(std::uint8_t *dst, const std::uint8_t *src, std::size_t n, int s){
+    for (std::size_t i = 0; i < n; i++){
+        dst[i] = static_cast<std::uint8_t>((src[i] << s) | (src[i + 1] >> (8 - s)));
+    }
+}
+
+#ifdef BYTEKERNELS_X86
+
+template <BitOp op>
+__m128i apply128(__m128i a, __m128i b){
+    if (op == BitOp::And) return _mm_and_si128(a, b);
+    if (op == BitOp::Or) return _mm_or_si128(a, b);
+    return _mm_xor_si128(a, b);
+}
+
+template <BitOp op>
+void binarySse2(std::uint8_t *dst, const std::uint8_t *src, std::size_t n){
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), apply128<op>(a, b));
+    }
+    binaryScalar<op>(dst + i, src + i, n - i);
+}
+
+void notSse2(std::uint8_t *dst, std::size_t n){
+    const __m128i ones = _mm_set1_epi8(-1);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_xor_si128(a, ones));
+    }
+    notScalar(dst + i, n - i);
+}
+
+// SSE 没有 8 位移位, 用 16 位移位再把越过字节边界的位屏蔽掉
+void funnelSse2(std::uint8_t *dst, const std::uint8_t *src, std::size_t n, int s){
+    const __m128i countHi = _mm_cvtsi32_si128(s);
+    const __m128i countLo = _mm_cvtsi32_si128(8 - s);
+    const __m128i maskHi = _mm_set1_epi8(static_cast<char>((0xFF << s) & 0xFF));
+    const __m128i maskLo = _mm_set1_epi8(static_cast<char>(0xFF >> (8 - s)));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 1));
+        const __m128i hi = _mm_and_si128(_mm_sll_epi16(a, countHi), maskHi);
+        const __m128i lo = _mm_and_si128(_mm_srl_epi16(b, countLo), maskLo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_or_si128(hi, lo));
+    }
+    funnelScalar(dst + i, src + i, n - i, s);
+}
+
+template <BitOp op>
+BYTEKERNELS_TARGET_AVX2 void binaryAvx2(std::uint8_t *dst, const std::uint8_t *src, std::size_t n){
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        __m256i r;
+        if (op == BitOp::And) r = _mm256_and_si256(a, b);
+        else if (op == BitOp::Or) r = _mm256_or_si256(a, b);
+        else r = _mm256_xor_si256(a, b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), r);
+    }
+    binarySse2<op>(dst + i, src + i, n - i);
+}
+
+BYTEKERNELS_TARGET_AVX2 void notAvx2(std::uint8_t *dst, std::size_t n){
+    const __m256i ones = _mm256_set1_epi8(-1);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_xor_si256(a, ones));
+    }
+    notSse2(dst + i, n - i);
+}
+
+BYTEKERNELS_TARGET_AVX2 void funnelAvx2(std::uint8_t *dst, const std::uint8_t *src, std::size_t n, int s){
+    const __m128i countHi = _mm_cvtsi32_si128(s);
+    const __m128i countLo = _mm_cvtsi32_si128(8 - s);
+    const __m256i maskHi = _mm256_set1_epi8(static_cast<char>((0xFF << s) & 0xFF));
+    const __m256i maskLo = _mm256_set1_epi8(static_cast<char>(0xFF >> (8 - s)));
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 1));
+        const __m256i hi = _mm256_and_si256(_mm256_sll_epi16(a, countHi), maskHi);
+        const __m256i lo = _mm256_and_si256(_mm256_srl_epi16(b, countLo), maskLo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_or_si256(hi, lo));
+    }
+    funnelSse2(dst + i, src + i, n - i, s);
+}
+
+#endif // BYTEKERNELS_X86
+
+struct Kernels {
+    void (*andBytes)(std::uint8_t *, const std::uint8_t *, std::size_t);
+    void (*orBytes)(std::uint8_t *, const std::uint8_t *, std::size_t);
+    void (*xorBytes)(std::uint8_t *, const std::uint8_t *, std::size_t);
+    void (*notBytes)(std::uint8_t *, std::size_t);
+    void (*funnel)(std::uint8_t *, const std::uint8_t *, std::size_t, int);
+    const char *name;
+};
+
+Kernels selectKernels(){
+#ifdef BYTEKERNELS_X86
+    if (cpuHasAvx2()){
+        return { binaryAvx2<BitOp::And>, binaryAvx2<BitOp::Or>, binaryAvx2<BitOp::Xor>,
+                 notAvx2, funnelAvx2, "avx2" };
+    }
+    return { binarySse2<BitOp::And>, binarySse2<BitOp::Or>, binarySse2<BitOp::Xor>,
+             notSse2, funnelSse2, "sse2" };
+#else
+    return { binaryScalar<BitOp::And>, binaryScalar<BitOp::Or>, binaryScalar<BitOp::Xor>,
+             notScalar, funnelScalar, "scalar" };
+#endif
+}
+
+const Kernels &kernels(){
+    static const Kernels k = selectKernels();
+    return k;
+}
+
+} // namespace
+
+void bytesAnd(std::uint8_t *dst, const std::uint8_t *src, std::size_t n){
+    kernels().andBytes(dst, src, n);
+}
+
+void bytesOr(std::uint8_t *dst, const std::uint8_t *src, std::size_t n){
+    kernels().orBytes(dst, src, n);
+}
+
+void bytesXor(std::uint8_t *dst, const std::uint8_t *src, std::size_t n){
+    kernels().xorBytes(dst, src, n);
+}
+
+void bytesNot(std::uint8_t *dst, std::size_t n){
+    kernels().notBytes(dst, n);
+}
+
+void bytesFunnelShift(std::uint8_t *dst, const std::uint8_t *src, std::size_t n, int s){
+    kernels().funnel(dst, src, n, s);
+}
+
+const char *byteKernelImplementation(){
+    return kernels().name;
+}
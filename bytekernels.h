@@ -0,0 +1,22 @@
+#ifndef BYTEKERNELS_H
+#define BYTEKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 字节数组上的按位运算, 与 hexscan 一样运行时选择 AVX2 / SSE2 / 标量实现
+
+// dst[i] op= src[i]
+void bytesAnd(std::uint8_t *dst, const std::uint8_t *src, std::size_t n);
+void bytesOr(std::uint8_t *dst, const std::uint8_t *src, std::size_t n);
+void bytesXor(std::uint8_t *dst, const std::uint8_t *src, std::size_t n);
+// dst[i] = ~dst[i]
+void bytesNot(std::uint8_t *dst, std::size_t n);
+// dst[i] = (src[i] << s) | (src[i + 1] >> (8 - s)), 1 <= s <= 7, src 需要 n + 1 个字节
+// 整段左移 / 右移都归结为这个跨字节拼接
+void bytesFunnelShift(std::uint8_t *dst, const std::uint8_t *src, std::size_t n, int s);
+
+// 当前使用的实现: "avx2" / "sse2" / "scalar"
+const char *byteKernelImplementation();
+
+#endif // BYTEKERNELS_H
@@ -2,48 +2,42 @@
 #define CALCULATORCORE_H
 
 #include <QString>
-#include <QVector>
 #include <QStringList>
+#include "hexengine.h"
 
+// HexEngine 的 Qt 适配层, 负责 QString <-> UTF-8 转换和文件保存
 class CalculatorCore
 {
 public:
     CalculatorCore();
 
+    using Backend = HexEngine::Backend;
+
     struct Result {
         QString valueStr;
         bool isError;
         QString errorMsg;
+        // 出错 token 在表达式中的位置 (QString 下标), 没有具体位置时 errorLength 为 0
+        int errorStart = 0;
+        int errorLength = 0;
     };
 
     Result compute(const QString &expression);
+    // 字节数组结果分块写入文件, 适合比内存还大的输入
+    Result computeToFile(const QString &expression, const QString &path);
 
-    static QString toHexFloatString(long double v, int fracDigits = 12);
+    void setBackend(Backend backend) { m_engine.setBackend(backend); }
+    Backend backend() const { return m_engine.backend(); }
 
-private:
-    enum class TokType {
-        Number,
-        Op,
-        UnaryPreOp,
-        UnaryPostOp,
-        LParen,
-        RParen
-    };
-    struct Token {
-        TokType type;
-        QString text;
-    };
+    static QStringList backendNames();
+    static QString backendName(Backend backend);
+    static bool backendFromName(const QString &name, Backend &out);
 
-    bool tokenize(const QString &expr, QVector<Token> &outTokens, QString &err) const;
-    bool toRpn(const QVector<Token> &tokens, QVector<Token> &outRpn, QString &err) const;
-    bool evalRpn(const QVector<Token> &rpn, long double &outValue, QString &err) const;
+    static QString toHexFloatString(long double v, int fracDigits = 12);
 
-    int precedence(const QString &op) const;
-    bool isLeftAssociative(const QString &op) const;
-    static bool parseHexFloat(const QString &s, long double &out, QString &err);
-    static long double fastPow(long double base, long long exp);
-    static long double safePow(long double a, long double b);
-    static long double factorial(long long n);
+private:
+    HexEngine m_engine;
+    std::string m_text;
 };
 
 #endif // CALCULATORCORE_H
@@ -0,0 +1,69 @@
+#include "cpufeatures.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+// regs: eax, ebx, ecx, edx; 不支持的 leaf 全部为 0
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]){
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(_MSC_VER) && defined(_M_X64)
+    int r[4];
+    __cpuid(r, static_cast<int>(leaf & 0x80000000u));
+    if (static_cast<unsigned>(r[0]) < leaf) return;
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) regs[i] = static_cast<unsigned>(r[i]);
+#elif defined(__x86_64__)
+    if (__get_cpuid_max(leaf & 0x80000000u, nullptr) < leaf) return;
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+    (void)leaf;
+    (void)subleaf;
+#endif
+}
+
+bool cpuidBit(unsigned leaf, int reg, int bit){
+    unsigned regs[4];
+    cpuid(leaf, 0, regs);
+    return (regs[reg] & (1u << bit)) != 0;
+}
+
+} // namespace
+
+bool cpuHasAvx2(){
+#if defined(_MSC_VER) && defined(_M_X64)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#elif defined(__x86_64__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpuHasPopcnt(){
+    return cpuidBit(1, 2, 23);
+}
+
+bool cpuHasLzcnt(){
+    // AMD 称为 ABM, Intel 从 Haswell 开始支持
+    return cpuidBit(0x80000001u, 2, 5);
+}
+
+bool cpuHasBmi1(){
+    return cpuidBit(7, 1, 3);
+}
+
+bool cpuHasBmi2(){
+    return cpuidBit(7, 1, 8);
+}
@@ -0,0 +1,13 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+// 运行时 CPU 特性检测, 供各个 SIMD 内核选择实现
+// 非 x86-64 平台上全部返回 false
+
+bool cpuHasAvx2();
+bool cpuHasPopcnt();
+bool cpuHasLzcnt();
+bool cpuHasBmi1();
+bool cpuHasBmi2();
+
+#endif // CPUFEATURES_H
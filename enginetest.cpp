@@ -0,0 +1,550 @@
+// 计算引擎的回归用例, 只依赖 hexcalccore, 由 ctest 运行
+#include "hexengine.h"
+#include "hexscan.h"
+#include "modarith.h"
+#include "programlib.h"
+#include "solver.h"
+#include "streamparser.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void expectResult(HexEngine::Backend backend, const char *expr, const char *expected){
+    HexEngine engine;
+    engine.setBackend(backend);
+    std::string out;
+    engine.compute(expr, out);
+    if (out != expected){
+        std::fprintf(stderr, "[%s] %s: got '%s', expected '%s'\n", HexEngine::backendName(backend), expr,
+                     out.c_str(), expected);
+        g_failures++;
+    }
+}
+
+// 超出 64 位的整数部分以十进制近似输出, 2^64 本身也算超出
+void testBackendLimits(){
+    const HexEngine::Backend floats[] = { HexEngine::Backend::Double, HexEngine::Backend::LongDouble,
+                                          HexEngine::Backend::Float128 };
+    for (const HexEngine::Backend b : floats){
+        if (!HexEngine::backendAvailable(b)) continue;
+        expectResult(b, "FFFFFFFFFFFFF800", "FFFFFFFFFFFFF800");
+        expectResult(b, "2^40", "1.84467440737096e+19");
+        expectResult(b, "10^10", "1.84467440737096e+19");
+    }
+    expectResult(HexEngine::Backend::Double, "FFFFFFFFFFFFFFFF", "1.84467440737096e+19");
+
+    // 定点数的最小值取反会溢出, 仍应按十六进制输出
+    expectResult(HexEngine::Backend::Fixed64, "0-7FFFFFFFFFFFFFFF-1", "-8000000000000000");
+    expectResult(HexEngine::Backend::Fixed64, "0-7FFFFFFFFFFFFFFF", "-7FFFFFFFFFFFFFFF");
+}
+
+// 运行时选择的 SIMD 实现与标量实现逐个比较: 各种长度, 每个位置上的非法字符, 小写字母
+void testHexScan(){
+    static const char digits[] = "0123456789ABCDEF";
+    // 紧挨着合法区间的字符, 以及小写的 a-f
+    static const char invalid[] = { '/', ':', '@', 'G', '`', 'a', 'f', 'g', ' ', '\0', '\x80', '\xFF' };
+    std::string text;
+    for (std::size_t len = 0; len <= 33; len++){
+        text.assign(len, '0');
+        for (std::size_t i = 0; i < len; i++) text[i] = digits[(i * 7 + len) & 0xF];
+        if (hexRunLength(text.data(), len) != len || hexRunLengthScalar(text.data(), len) != len){
+            std::fprintf(stderr, "hexRunLength: valid run of %zu\n", len);
+            g_failures++;
+        }
+        for (std::size_t pos = 0; pos < len; pos++){
+            for (const char bad : invalid){
+                std::string s = text;
+                s[pos] = bad;
+                if (hexRunLength(s.data(), len) != pos || hexRunLengthScalar(s.data(), len) != pos){
+                    std::fprintf(stderr, "hexRunLength: length %zu, char %02X at %zu\n", len, bad & 0xFF, pos);
+                    g_failures++;
+                }
+            }
+        }
+    }
+
+    // 混合大小写: 小写字母同样是非法字符
+    const std::string mixed = "0123456789ABCDEFabcdef0123456789ABCDEF0123456789abcdefABCDEF0123";
+    if (hexRunLength(mixed.data(), mixed.size()) != 16 || hexRunLengthScalar(mixed.data(), mixed.size()) != 16){
+        std::fprintf(stderr, "hexRunLength: lower case must stop the run\n");
+        g_failures++;
+    }
+
+    // hexToWords: 64 个字符 (4 个字), 任意位置放入非法字符
+    std::string words(64, '0');
+    for (std::size_t i = 0; i < words.size(); i++) words[i] = digits[(i * 5 + 3) & 0xF];
+    for (std::size_t pos = 0; pos <= words.size(); pos++){
+        std::string s = words;
+        if (pos < s.size()) s[pos] = pos % 2 ? 'a' : 'G';
+        std::uint64_t a[4] = {};
+        std::uint64_t b[4] = {};
+        const std::size_t na = hexToWords(s.data(), s.size(), a);
+        const std::size_t nb = hexToWordsScalar(s.data(), s.size(), b);
+        bool same = na == pos / 16 && nb == na;
+        for (std::size_t k = 0; same && k < na; k++) same = a[k] == b[k];
+        if (!same){
+            std::fprintf(stderr, "hexToWords: invalid char at %zu: %zu / %zu words\n", pos, na, nb);
+            g_failures++;
+        }
+    }
+    std::uint64_t w = 0;
+    if (!hexToWord("FEDCBA9876543210", 16, w) || w != 0xFEDCBA9876543210ull || hexToWord("FEDCBa98", 8, w)){
+        std::fprintf(stderr, "hexToWord: wrong conversion\n");
+        g_failures++;
+    }
+}
+
+// 错误码和出错 token 在表达式中的字节区间
+void expectError(const char *expr, HexErrorCode code, std::size_t offset, std::size_t length){
+    HexEngine engine;
+    std::string out;
+    HexError err;
+    if (engine.compute(expr, out, err) || err.code != code || err.offset != offset || err.length != length){
+        std::fprintf(stderr, "%s: got error %d@%zu+%zu, expected %d@%zu+%zu\n", expr, static_cast<int>(err.code), err.offset,
+                     err.length, static_cast<int>(code), offset, length);
+        g_failures++;
+    }
+}
+
+void testErrorSpans(){
+    expectError("", HexErrorCode::EmptyExpression, 0, 0);
+    expectError("1 $ 2", HexErrorCode::UnexpectedChar, 2, 1);
+    expectError("1 + \xE4\xBD\xA0", HexErrorCode::UnexpectedChar, 4, 3);
+    expectError("1 < 2", HexErrorCode::InvalidOperator, 2, 1);
+    expectError("(1 + 2", HexErrorCode::MismatchedParentheses, 0, 1);
+    expectError("1 + 2)", HexErrorCode::MismatchedParentheses, 5, 1);
+    expectError("1 +", HexErrorCode::NotEnoughOperands, 2, 1);
+    expectError("10 / (3 - 3)", HexErrorCode::DivisionByZero, 3, 1);
+    expectError("5 % 0", HexErrorCode::ModuloByZero, 2, 1);
+    expectError("POPCNT 1.8", HexErrorCode::IntegerRequired, 0, 6);
+    expectError("FFFF << 40", HexErrorCode::ShiftOutOfRange, 5, 2);
+    expectError("1 + KEY", HexErrorCode::UnknownVariable, 4, 3);
+    expectError("2 MOD 0", HexErrorCode::InvalidModulus, 6, 1);
+
+    // 错误信息只在需要时按区间从表达式中取出 token
+    std::string msg;
+    HexEngine::formatError({ HexErrorCode::UnexpectedChar, 2, 1 }, "1 $ 2", msg);
+    if (msg != "unexpected char '$'"){
+        std::fprintf(stderr, "formatError: got '%s'\n", msg.c_str());
+        g_failures++;
+    }
+}
+
+// 模运算: 结果由 Python 的大整数计算得到
+void testModular(){
+    struct Case {
+        const char *expr;
+        const char *expected;
+    };
+    const Case cases[] = {
+        // 奇数模, Montgomery: 64 / 127 / 255 位
+        { "123456789ABCDEF0FEDCBA9876543210 * DEADBEEFCAFEBABE0123456789 + 1111 MOD FFFFFFFFFFFFFFC5",
+          "A22C0728A290611D" },
+        { "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD FFFFFFFFFFFFFFC5",
+          "AA9474800F099B2" },
+        { "DEADBEEFCAFEBABE0123456789 - 123456789ABCDEF0FEDCBA9876543210 MOD FFFFFFFFFFFFFFC5",
+          "CDCE48EF0E6B1690" },
+        { "123456789ABCDEF0FEDCBA9876543210 * DEADBEEFCAFEBABE0123456789 + 1111 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+          "4723F2E31CA2D83DDD985E5F3CF4E628" },
+        { "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+          "79CEE16D903910E02388A333B3C87C22" },
+        { "DEADBEEFCAFEBABE0123456789 - 123456789ABCDEF0FEDCBA9876543210 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+          "6DCBAA66130210D9FFDE0368ACF13578" },
+        { "123456789ABCDEF0FEDCBA9876543210 * DEADBEEFCAFEBABE0123456789 + 1111 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFED",
+          "FD5BDEEEB2A01D8C92DB8CD43C723F2C37126FA678994ACCCE1834BA1" },
+        { "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFED",
+          "3DD8F8BAF03CB42717AEEA3FBD3AB2B47F4333D74D6B2857563F69BE2F30C902" },
+        { "DEADBEEFCAFEBABE0123456789 - 123456789ABCDEF0FEDCBA9876543210 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFED",
+          "7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEDCBAA66130210D9FFDE0368ACF13566" },
+        { "123456789ABCDEF0FEDCBA9876543210 / DEADBEEFCAFEBABE0123456789 MOD FFFFFFFFFFFFFFC5",
+          "E1CC08B9D189BC1B" },
+        { "INV DEADBEEFCAFEBABE0123456789 MOD FFFFFFFFFFFFFFC5",
+          "7B6098C721519477" },
+        { "123456789ABCDEF0FEDCBA9876543210 / DEADBEEFCAFEBABE0123456789 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+          "471E459D9E429B3B65B26E7D75C5FD6C" },
+        { "INV DEADBEEFCAFEBABE0123456789 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+          "62E99646A8A7A99BEEB134868973825" },
+        { "123456789ABCDEF0FEDCBA9876543210 / DEADBEEFCAFEBABE0123456789 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFED",
+          "196BE9012FA0FCEE233123C2F69CACB86948C91565179213749CCBA7B9C5CEFB" },
+        { "INV DEADBEEFCAFEBABE0123456789 MOD 7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFED",
+          "2E3E3896C5C0C8D94C1C8EDB0975D3FEFC91F0434B821715782E83B696DFE0E5" },
+        // 521 位, 奇数模与偶数模
+        {
+          "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD 1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+          "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+          "1C2E7D93DB3757CE12262BC4F9B71CE1EC299447E5F2203FF7220D68A9D9C051E691BA9C637B903CCB25DAC0B0BEA333"
+          "E082428CFEFC7C6BF6EC279CDE808A49B10" },
+        {
+          "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD 1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+          "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFE",
+          "9A384B9AF65ECA937BFF5CABBB8E7F53470BE7D7E760DDCB3FD1A32D25C832C7D4C34213CB6D2889D52C1FABE59AA7D6"
+          "68B5AF5B81E829AABD38AFEA29681B8FC4" },
+        // 偶数模, Barrett
+        { "123456789ABCDEF0FEDCBA9876543210 * DEADBEEFCAFEBABE0123456789 + 1111 MOD 100000000000000000000000000000906",
+          "C72363E0C14D1C6A7CEA857A4FF7210F" },
+        { "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD 100000000000000000000000000000906",
+          "599D19C71685FDF8ADB58DAC7CBC0CDE" },
+        { "DEADBEEFCAFEBABE0123456789 - 123456789ABCDEF0FEDCBA9876543210 MOD 100000000000000000000000000000906",
+          "EDCBAA66130210D9FFDE0368ACF13E7F" },
+        { "INV 3 MOD 100000000000000000000000000000906",
+          "AAAAAAAAAAAAAAAAAAAAAAAAAAAAB0AF" },
+        // 2 的幂, 按位截断
+        { "123456789ABCDEF0FEDCBA9876543210 * DEADBEEFCAFEBABE0123456789 + 1111 MOD 10000000000000000000000000",
+          "37126FA678994ACCCE1834BA1" },
+        { "123456789ABCDEF0FEDCBA9876543210 ^ 10001 MOD 10000000000000000000000000",
+          "0" },
+        { "DEADBEEFCAFEBABE0123456789 - 123456789ABCDEF0FEDCBA9876543210 MOD 10000000000000000000000000",
+          "6130210D9FFDE0368ACF13579" },
+        { "INV 7 MOD 10000000000000000000000000",
+          "6DB6DB6DB6DB6DB6DB6DB6DB7" },
+    };
+    for (const Case &c : cases) expectResult(HexEngine::Backend::Double, c.expr, c.expected);
+
+    // 奇偶决定约简方式
+    HexErrorCode code = HexErrorCode::None;
+    ModContext odd;
+    ModContext even;
+    if (!odd.setModulus("7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", code) || !odd.isMontgomery()
+        || !even.setModulus("100000000000000000000000000000906", code) || even.isMontgomery()){
+        std::fprintf(stderr, "ModContext: wrong reduction for odd / even moduli\n");
+        g_failures++;
+    }
+
+    expectError("INV 6 MOD 100000000000000000000000000000906", HexErrorCode::NotInvertible, 0, 3);
+    expectError("INV 0 MOD 7", HexErrorCode::NotInvertible, 0, 3);
+    expectError("4 / 2 MOD 10", HexErrorCode::NotInvertible, 2, 1);
+    expectError("5 MOD 0", HexErrorCode::InvalidModulus, 6, 1);
+    expectError("5 MOD 1", HexErrorCode::InvalidModulus, 6, 1);
+}
+
+// 位操作: 0 / 全 1 / 移位数 3F 和 40 等边界
+void testBitOperators(){
+    const HexEngine::Backend all[] = { HexEngine::Backend::Double, HexEngine::Backend::LongDouble,
+                                       HexEngine::Backend::Float128, HexEngine::Backend::Fixed64 };
+    for (const HexEngine::Backend b : all){
+        if (!HexEngine::backendAvailable(b)) continue;
+        expectResult(b, "POPCNT 0", "0");
+        expectResult(b, "POPCNT F0F0", "8");
+        expectResult(b, "CLZ 0", "40");
+        expectResult(b, "CTZ 0", "40");
+        expectResult(b, "CLZ 1", "3F");
+        expectResult(b, "CTZ 100", "8");
+        expectResult(b, "PARITY 0", "0");
+        expectResult(b, "PARITY 7", "1");
+        expectResult(b, "BSWAP 0", "0");
+        expectResult(b, "BITREV 0", "0");
+        expectResult(b, "1 ROL 40", "1");
+        expectResult(b, "1 ROR 40", "1");
+        expectResult(b, "2 ROR 1", "1");
+        expectResult(b, "F0F0 PEXT FF00", "F0");
+        expectResult(b, "F PDEP F0F0", "F0");
+        expectResult(b, "5 PDEP 0", "0");
+        expectResult(b, "~0", "-1");
+        expectResult(b, "~5", "-6");
+    }
+
+    // 完整的 64 位字, 需要至少 64 位尾数的后端
+    std::vector<HexEngine::Backend> wide;
+    if (std::numeric_limits<long double>::digits >= 64) wide.push_back(HexEngine::Backend::LongDouble);
+    if (HexEngine::backendAvailable(HexEngine::Backend::Float128)) wide.push_back(HexEngine::Backend::Float128);
+    for (const HexEngine::Backend b : wide){
+        expectResult(b, "POPCNT FFFFFFFFFFFFFFFF", "40");
+        expectResult(b, "CLZ FFFFFFFFFFFFFFFF", "0");
+        expectResult(b, "CTZ 8000000000000000", "3F");
+        expectResult(b, "PARITY FFFFFFFFFFFFFFFF", "0");
+        expectResult(b, "BSWAP 0102030405060708", "807060504030201");
+        expectResult(b, "BSWAP FF", "FF00000000000000");
+        expectResult(b, "BITREV 1", "8000000000000000");
+        expectResult(b, "BITREV FFFFFFFFFFFFFFFF", "FFFFFFFFFFFFFFFF");
+        expectResult(b, "1 ROL 3F", "8000000000000000");
+        expectResult(b, "8000000000000000 ROR 3F", "1");
+        expectResult(b, "8000000000000001 ROL 1", "3");
+        expectResult(b, "8000000000000001 ROR 1", "C000000000000000");
+        expectResult(b, "FFFFFFFFFFFFFFFF ROL 5", "FFFFFFFFFFFFFFFF");
+        expectResult(b, "123456789ABCDEF0 PEXT F0F0F0F0F0F0F0F0", "13579BDF");
+        expectResult(b, "13579BDF PDEP F0F0F0F0F0F0F0F0", "1030507090B0D0F0");
+        expectResult(b, "FFFFFFFFFFFFFFFF PEXT FFFFFFFFFFFFFFFF", "FFFFFFFFFFFFFFFF");
+        expectResult(b, "FFFFFFFFFFFFFFFF PDEP 8000000000000001", "8000000000000001");
+        expectResult(b, "~FFFFFFFFFFFFFFFF", "0");
+        expectResult(b, "7FFFFFFFFFFFFFFF << 1", "-2");
+        expectResult(b, "FFFFFFFFFFFFFFFF << 4", "-10");
+    }
+}
+
+// 字节数组: 奇数位字面量在前面补 0, 短的一方在末尾补 0, 第 0 字节为最高位
+void testByteArrays(){
+    const HexEngine::Backend b = HexEngine::Backend::Double;
+    expectResult(b, "#ABC", "#0ABC");
+    expectResult(b, "#F", "#0F");
+    expectResult(b, "#0123 << 4", "#1230");
+    expectResult(b, "#0123 << C", "#3000");
+    expectResult(b, "#0123 >> 4", "#0012");
+    expectResult(b, "#8001 >> 1", "#4000");
+    expectResult(b, "#0180 << 1", "#0300");
+    expectResult(b, "#0123 << 11", "#0000");
+    expectResult(b, "#0123 ROL 4", "#1230");
+    expectResult(b, "#0123 ROR 4", "#3012");
+    expectResult(b, "#0123 ROL 14", "#1230");
+    expectResult(b, "#8001 ROL 1", "#0003");
+    expectResult(b, "#FF00FF ^^ #0F", "#F000FF");
+    expectResult(b, "#12 | #0034", "#1234");
+    expectResult(b, "#FFFF & F0", "#F0F0");
+    expectResult(b, "~#00FF", "#FF00");
+    expectResult(b, "BSWAP #0102", "#0201");
+    expectResult(b, "POPCNT #FFF", "C");
+    expectResult(b, "CLZ #0001", "F");
+    expectResult(b, "CTZ #0100", "8");
+    // 标量部分按 64 位回绕
+    expectResult(b, "#01 << (7FFFFFFFFFFFFFFF + 1 - 7FFFFFFFFFFFFFFF)", "#02");
+    expectResult(b, "#FF & (4000000000000000 * 4 + 7)", "#07");
+
+    // 分块写出 (--output): 跨块的移位 / 循环移位与逐字节计算的结果一致
+    const std::string path = (std::filesystem::temp_directory_path() / "hexcalc_test.bin").string();
+    const std::size_t size = (3u << 20) + 5;
+    std::vector<std::uint8_t> data(size);
+    for (std::size_t i = 0; i < size; i++) data[i] = static_cast<std::uint8_t>(i * 7 + (i >> 12));
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    const bool written = f && std::fwrite(data.data(), 1, size, f) == size;
+    if (f) std::fclose(f);
+    if (!written){
+        std::fprintf(stderr, "bytes: cannot write %s\n", path.c_str());
+        g_failures++;
+        return;
+    }
+
+    std::vector<std::uint8_t> shr(size);
+    std::vector<std::uint8_t> rol(size);
+    for (std::size_t i = 0; i < size; i++){
+        shr[i] = static_cast<std::uint8_t>((i ? data[i - 1] << 4 : 0) | data[i] >> 4);
+        rol[i] = static_cast<std::uint8_t>(data[i] << 4 | data[(i + 1) % size] >> 4);
+    }
+    const struct {
+        std::string expr;
+        const std::vector<std::uint8_t> &expected;
+    } cases[] = {
+        { "\"" + path + "\" >> 4", shr },
+        { "\"" + path + "\" ROL 4", rol }
+    };
+    HexEngine engine;
+    for (const auto &c : cases){
+        std::vector<std::uint8_t> out;
+        int chunks = 0;
+        std::int64_t n = 0;
+        HexError err;
+        const bool ok = engine.writeBytes(c.expr, [&out, &chunks](const std::uint8_t *p, std::size_t len){
+            out.insert(out.end(), p, p + len);
+            chunks++;
+            return true;
+        }, n, err);
+        if (!ok || n != static_cast<std::int64_t>(size) || chunks < 2 || out != c.expected){
+            std::fprintf(stderr, "bytes: %s written in %d chunks does not match\n", c.expr.c_str(), chunks);
+            g_failures++;
+        }
+    }
+
+    // sink 失败时报告 WriteFailed
+    std::int64_t n = 0;
+    HexError err;
+    if (engine.writeBytes(cases[0].expr, [](const std::uint8_t *, std::size_t){ return false; }, n, err)
+        || err.code != HexErrorCode::WriteFailed){
+        std::fprintf(stderr, "bytes: a failing sink must report WriteFailed\n");
+        g_failures++;
+    }
+    std::filesystem::remove(path);
+}
+
+// 按 split 切成两块 (split 为 0 时按 chunk 字节一块) 送入 StreamParser, 返回以空格分隔的逆波兰 token
+bool streamRpn(const std::string &expr, std::size_t chunk, std::size_t split, std::string &rpn, HexError &err){
+    rpn.clear();
+    StreamParser parser([&rpn](const StreamParser::Item &item){
+        if (!rpn.empty()) rpn += ' ';
+        rpn += item.text;
+    });
+    std::vector<std::string_view> parts;
+    const std::string_view all(expr);
+    if (split) parts = { all.substr(0, split), all.substr(split) };
+    for (std::size_t i = 0; !split && i < all.size(); i += chunk) parts.push_back(all.substr(i, chunk));
+    for (const std::string_view part : parts){
+        if (!parser.feed(part, err)) return false;
+    }
+    return parser.finish(err);
+}
+
+// 任意切分方式的结果都与整块送入 HexEngine 相同
+void expectStream(const std::string &expr, const char *expected){
+    for (std::size_t mode = 0; mode < 2 * expr.size(); mode++){
+        const std::size_t chunk = mode < expr.size() ? mode + 1 : 0;
+        const std::size_t split = mode < expr.size() ? 0 : mode - expr.size();
+        if (!chunk && !split) continue;
+        std::string rpn;
+        HexError err;
+        if (!streamRpn(expr, chunk, split, rpn, err) || rpn != expected){
+            std::fprintf(stderr, "stream '%s' (chunk %zu, split %zu): got '%s', expected '%s'\n", expr.c_str(), chunk, split,
+                         rpn.c_str(), expected);
+            g_failures++;
+            return;
+        }
+    }
+}
+
+void expectStreamError(const std::string &expr){
+    HexEngine engine;
+    std::string out;
+    HexError expected;
+    engine.compute(expr, out, expected);
+    for (std::size_t chunk = 1; chunk <= expr.size(); chunk++){
+        std::string rpn;
+        HexError err;
+        if (streamRpn(expr, chunk, 0, rpn, err) || err.code != expected.code || err.offset != expected.offset
+            || err.length != expected.length){
+            std::fprintf(stderr, "stream '%s' (chunk %zu): error %d@%zu+%zu, engine %d@%zu+%zu\n", expr.c_str(), chunk,
+                         static_cast<int>(err.code), err.offset, err.length, static_cast<int>(expected.code),
+                         expected.offset, expected.length);
+            g_failures++;
+            return;
+        }
+    }
+}
+
+void testStreamParser(){
+    expectStream("1 << 2", "1 2 <<");
+    expectStream("1>>2<<3", "1 2 >> 3 <<");
+    expectStream("FF ^^ 0F", "FF 0F ^^");
+    expectStream("2 ^ ^ 3", "2 3 ^^");
+    expectStream("2 ^  3", "2 3 ^");
+    expectStream("2^3^4", "2 3 4 ^ ^");
+    expectStream("123456789ABCDEF0 + ABCDEF.123", "123456789ABCDEF0 ABCDEF.123 +");
+    expectStream("FFROL 4", "FF 4 ROL");
+    expectStream("POPCNT(FF) + 1 * ~2", "FF POPCNT 1 2 ~ * +");
+    expectStream("#DEADBEEF ^^ KEY", "DEADBEEF KEY ^^");
+
+    // 被块边界截断的 UTF-8 字符整个报错; 多余的 ")" 后面的词法错误优先
+    expectStreamError("1 + \xE4\xBD\xA0 2");
+    expectStreamError(")\xE4\xBD\xA0");
+    expectStreamError("1) + $");
+    expectStreamError("1) + 2");
+    expectStreamError("(1 + 2");
+    expectStreamError("1 < 2");
+    expectStreamError("1 + #");
+    expectStreamError("\"abc");
+    expectStreamError(". + 1");
+}
+
+void expectSolutions(const char *expr, const char *target, std::int64_t lo, std::int64_t hi,
+                     const std::vector<std::int64_t> &expected){
+    HexEngine engine;
+    Program program;
+    HexError compileErr;
+    std::string err;
+    Solver::Options options;
+    std::vector<std::int64_t> solutions;
+    if (!engine.compile(expr, program, compileErr)
+        || !Solver::parseTarget(target, options.compare, options.target, err)){
+        std::fprintf(stderr, "solve %s: setup failed\n", expr);
+        g_failures++;
+        return;
+    }
+    options.ranges.assign(program.vars.size(), Solver::Range{ lo, hi });
+    if (!Solver::solve(program, options, solutions, err) || solutions != expected){
+        std::fprintf(stderr, "solve %s %s: got %zu solutions, expected %zu\n", expr, target, solutions.size(),
+                     expected.size());
+        g_failures++;
+    }
+}
+
+// 求解器找到的解必须与直接计算一致: 除不尽 / 溢出的取值不是解
+void testSolverAgreesWithCompute(){
+    expectSolutions("X / 3", "=5", 0, 0xFF, { 0xF });
+    // 回绕时 100000000 * 100000000 为 0
+    expectSolutions("X * 100000000", "=0", 0xFFFFFF00, 0x100000100, {});
+    expectSolutions("X * 100000000", "=0", 0 - 0xFF, 0xFF, { 0 });
+    expectSolutions("X + 7FFFFFFFFFFFFFFF", "<0", 0, 0xFF, {});
+    expectSolutions("1 << X", "<0", 0, 0x3F, { 0x3F });
+    expectSolutions("BSWAP X", "<0", 0, 0xFF, {});
+    expectSolutions("X ^ 2", "=10", 0 - 0xFF, 0xFF, { -4, 4 });
+    expectSolutions("CLZ X + CTZ X", "=80", 0 - 0xF, 0xF, { 0 });
+    expectSolutions("POPCNT X", "=40", 0 - 0xF, 0xF, { -1 });
+    expectSolutions("PARITY X", "=1", 0, 7, { 1, 2, 4, 7 });
+    expectSolutions("X PEXT F0", "=F", 0, 0x1FF, { 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD,
+                                                 0xFE, 0xFF, 0x1F0, 0x1F1, 0x1F2, 0x1F3, 0x1F4, 0x1F5, 0x1F6, 0x1F7, 0x1F8, 0x1F9,
+                                                 0x1FA, 0x1FB, 0x1FC, 0x1FD, 0x1FE, 0x1FF });
+    expectSolutions("X PDEP 8001", "=1", 0, 0xF, { 1, 5, 9, 0xD });
+    // 结果最高位为 1 时计算器输出的是正数, 不是解
+    expectSolutions("X ROL 3F", ">=1", 0, 3, { 2 });
+    expectResult(HexEngine::Backend::Double, "1 << 3F", "-8000000000000000");
+
+    // 直接计算把 FFFFFFFFFFFFFFFF 当作 2^64 - 1, 编译时不能按补码变成 -1
+    HexEngine engine;
+    Program program;
+    HexError err;
+    if (engine.compile("X + FFFFFFFFFFFFFFFF", program, err) || err.code != HexErrorCode::ConstantTooLarge){
+        std::fprintf(stderr, "X + FFFFFFFFFFFFFFFF: expected ConstantTooLarge\n");
+        g_failures++;
+    }
+    if (!engine.compile("X + 7FFFFFFFFFFFFFFF", program, err)){
+        std::fprintf(stderr, "X + 7FFFFFFFFFFFFFFF: compile failed\n");
+        g_failures++;
+    }
+}
+
+// 库中的程序直接交给求解器; 非整数表达式在编译时给出与库无关的错误
+void testProgramLibrary(){
+    HexEngine engine;
+    Program program;
+    HexError compileErr;
+    if (engine.compile("A.8 * X", program, compileErr) || compileErr.code != HexErrorCode::NotCompilable){
+        std::fprintf(stderr, "A.8 * X: expected NotCompilable\n");
+        g_failures++;
+    }
+    if (!engine.compile("X / 3", program, compileErr)){
+        std::fprintf(stderr, "X / 3: compile failed\n");
+        g_failures++;
+        return;
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "hexcalc_test.hxl").string();
+    HexErrorCode code = HexErrorCode::None;
+    ProgramLibrary lib;
+    ProgramView view;
+    if (!ProgramLibrary::write(path, { { "DIV3", program } }, code) || std::filesystem::exists(path + ".tmp")
+        || !lib.open(path, code) || !lib.find("DIV3", view) || !view.verify()){
+        std::fprintf(stderr, "program library: write / open failed\n");
+        g_failures++;
+        return;
+    }
+
+    std::string err;
+    Solver::Options options;
+    std::vector<std::int64_t> solutions;
+    options.target = 5;
+    options.ranges.assign(view.varCount, Solver::Range{ 0, 0xFF });
+    if (!Solver::solve(view, options, solutions, err) || solutions != std::vector<std::int64_t>{ 0xF }){
+        std::fprintf(stderr, "program library: solving a loaded program failed\n");
+        g_failures++;
+    }
+    lib.close();
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+int main(){
+    testBackendLimits();
+    testHexScan();
+    testErrorSpans();
+    testBitOperators();
+    testByteArrays();
+    testModular();
+    testStreamParser();
+    testSolverAgreesWithCompute();
+    testProgramLibrary();
+    if (g_failures) std::fprintf(stderr, "%d failures\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "hexcalc.h"
+#include "hexengine.h"
+#include <algorithm>
+#include <cstring>
+
+struct hexcalc_engine {
+    HexEngine engine;
+    std::string text;
+};
+
+static_assert(HEXCALC_ERR_NONE == static_cast<int>(HexErrorCode::None)
+              && HEXCALC_ERR_OUT_OF_MEMORY == static_cast<int>(HexErrorCode::OutOfMemory),
+              "hexcalc_error_code must match HexErrorCode");
+
+namespace {
+
+// 引擎只在分配内存失败时抛出异常 (bad_alloc / length_error), 异常不能穿过 C 接口,
+// 每个可能分配内存的入口都在 catch 里转成 HEXCALC_ERR_OUT_OF_MEMORY; 这时不能再分配, 信息用静态字符串
+constexpr std::string_view kOutOfMemory = "out of memory";
+
+// 按 snprintf 的方式截断复制, 返回完整长度
+std::size_t copyText(std::string_view msg, char *out, std::size_t cap){
+    if (out && cap > 0){
+        const std::size_t n = std::min(msg.size(), cap - 1);
+        std::memcpy(out, msg.data(), n);
+        out[n] = '\0';
+    }
+    return msg.size();
+}
+
+} // namespace
+
+int hexcalc_abi_version(void){
+    return HEXCALC_ABI_VERSION;
+}
+
+hexcalc_engine *hexcalc_create(void){
+    try {
+        return new hexcalc_engine;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void hexcalc_destroy(hexcalc_engine *engine){
+    delete engine;
+}
+
+int hexcalc_set_backend(hexcalc_engine *engine, int backend){
+    if (!engine || backend < HEXCALC_BACKEND_DOUBLE || backend > HEXCALC_BACKEND_FIXED64) return HEXCALC_INVALID_ARGUMENT;
+
+    // hexcalc_backend 与 HexEngine::Backend 取值一一对应
+    const auto b = static_cast<HexEngine::Backend>(backend);
+    if (!HexEngine::backendAvailable(b)) return HEXCALC_INVALID_ARGUMENT;
+    engine->engine.setBackend(b);
+    return HEXCALC_OK;
+}
+
+int hexcalc_eval(hexcalc_engine *engine, const char *expr, size_t expr_len,
+                 char *out, size_t out_cap, size_t *out_len){
+    if (!engine || (!expr && expr_len > 0) || (!out && out_cap > 0)) return HEXCALC_INVALID_ARGUMENT;
+
+    try {
+        const HexEngine::Result r = engine->engine.compute(std::string_view(expr, expr_len), out, out_cap);
+        if (out_len) *out_len = r.length;
+        return r.isError ? HEXCALC_ERROR : HEXCALC_OK;
+    } catch (...) {
+        const std::size_t len = copyText(kOutOfMemory, out, out_cap);
+        if (out_len) *out_len = len;
+        return HEXCALC_ERROR;
+    }
+}
+
+int hexcalc_eval_ex(hexcalc_engine *engine, const char *expr, size_t expr_len,
+                    char *out, size_t out_cap, size_t *out_len, hexcalc_error *err){
+    if (!engine || (!expr && expr_len > 0) || (!out && out_cap > 0)) return HEXCALC_INVALID_ARGUMENT;
+
+    HexError e;
+    bool ok = false;
+    try {
+        ok = engine->engine.compute(std::string_view(expr, expr_len), engine->text, e);
+    } catch (...) {
+        e = { HexErrorCode::OutOfMemory, 0, 0 };
+    }
+    if (!ok) engine->text.clear();
+    const std::size_t len = copyText(engine->text, out, out_cap);
+    if (out_len) *out_len = len;
+    if (err) *err = { static_cast<int>(e.code), e.offset, e.length };
+    return ok ? HEXCALC_OK : HEXCALC_ERROR;
+}
+
+size_t hexcalc_eval_batch(hexcalc_engine *engine, hexcalc_job *jobs, size_t count){
+    if (!engine || !jobs) return count;
+
+    size_t failures = 0;
+    for (size_t i = 0; i < count; i++){
+        hexcalc_job &job = jobs[i];
+        job.status = hexcalc_eval(engine, job.expr, job.expr_len, job.out, job.out_cap, &job.out_len);
+        if (job.status != HEXCALC_OK) failures++;
+    }
+    return failures;
+}
+
+size_t hexcalc_eval_batch_ex(hexcalc_engine *engine, hexcalc_job *jobs, hexcalc_error *errors, size_t count){
+    if (!engine || !jobs || !errors) return count;
+
+    size_t failures = 0;
+    for (size_t i = 0; i < count; i++){
+        hexcalc_job &job = jobs[i];
+        job.status = hexcalc_eval_ex(engine, job.expr, job.expr_len, job.out, job.out_cap, &job.out_len, &errors[i]);
+        if (job.status != HEXCALC_OK) failures++;
+    }
+    return failures;
+}
+
+size_t hexcalc_error_message(const hexcalc_error *err, const char *expr, size_t expr_len,
+                             char *out, size_t out_cap){
+    if (!err || (!expr && expr_len > 0)) return 0;
+
+    const HexError e{ static_cast<HexErrorCode>(err->code), err->offset, err->length };
+    try {
+        std::string msg;
+        HexEngine::formatError(e, std::string_view(expr, expr_len), msg);
+        return copyText(msg, out, out_cap);
+    } catch (...) {
+        return copyText(kOutOfMemory, out, out_cap);
+    }
+}
+
+int hexcalc_write_bytes(hexcalc_engine *engine, const char *expr, size_t expr_len,
+                        hexcalc_sink sink, void *ctx, int64_t *written,
+                        char *err, size_t err_cap){
+    if (!engine || !sink || (!expr && expr_len > 0)) return HEXCALC_INVALID_ARGUMENT;
+
+    HexError e;
+    std::int64_t n = 0;
+    const std::string_view view(expr, expr_len);
+    try {
+        const bool ok = engine->engine.writeBytes(view,
+                                                  [sink, ctx](const std::uint8_t *data, std::size_t len){
+                                                      return sink(ctx, data, len) == 0;
+                                                  },
+                                                  n, e);
+        if (written) *written = n;
+        if (!ok){
+            engine->text.clear();
+            HexEngine::formatError(e, view, engine->text);
+            copyText(engine->text, err, err_cap);
+            return HEXCALC_ERROR;
+        }
+        return HEXCALC_OK;
+    } catch (...) {
+        if (written) *written = n;
+        copyText(kOutOfMemory, err, err_cap);
+        return HEXCALC_ERROR;
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef HEXCALC_H
+#define HEXCALC_H
+
+/*
+ * HexCalculator 计算引擎的 C 接口
+ * 只增不改: 新功能追加新函数, 已有函数和结构体布局保持不变
+ * 表达式为 UTF-8, 不要求以 0 结尾; 输出按 snprintf 的方式写入调用方的缓冲区
+ * 一个 hexcalc_engine 同一时间只能被一个线程使用
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(HEXCALC_BUILDING)
+#    define HEXCALC_API __declspec(dllexport)
+#  else
+#    define HEXCALC_API __declspec(dllimport)
+#  endif
+#else
+#  define HEXCALC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 2: 增加 hexcalc_eval_ex / hexcalc_eval_batch_ex / hexcalc_error_message */
+#define HEXCALC_ABI_VERSION 2
+
+typedef struct hexcalc_engine hexcalc_engine;
+
+enum hexcalc_backend {
+    HEXCALC_BACKEND_DOUBLE = 0,
+    HEXCALC_BACKEND_LONG_DOUBLE = 1,
+    HEXCALC_BACKEND_FLOAT128 = 2,
+    HEXCALC_BACKEND_FIXED64 = 3
+};
+
+enum hexcalc_status {
+    HEXCALC_OK = 0,
+    HEXCALC_ERROR = 1,          /* 表达式错误或内存不足, 输出缓冲区里是错误信息 */
+    HEXCALC_INVALID_ARGUMENT = 2
+};
+
+/* 错误码, 取值与 HexErrorCode 相同 */
+enum hexcalc_error_code {
+    HEXCALC_ERR_NONE = 0,
+    HEXCALC_ERR_EMPTY_EXPRESSION = 1,
+    HEXCALC_ERR_UNEXPECTED_CHAR = 2,
+    HEXCALC_ERR_INVALID_OPERATOR = 3,
+    HEXCALC_ERR_INVALID_NUMBER = 4,
+    HEXCALC_ERR_EMPTY_BYTE_LITERAL = 5,
+    HEXCALC_ERR_UNTERMINATED_FILE_NAME = 6,
+    HEXCALC_ERR_MISMATCHED_PARENTHESES = 7,
+    HEXCALC_ERR_NOT_ENOUGH_OPERANDS = 8,
+    HEXCALC_ERR_NOT_ENOUGH_OPERANDS_UNARY = 9,
+    HEXCALC_ERR_INVALID_EXPRESSION = 10,
+    HEXCALC_ERR_UNKNOWN_OPERATOR = 11,
+    HEXCALC_ERR_UNKNOWN_VARIABLE = 12,
+    HEXCALC_ERR_INVALID_INTEGER_DIGIT = 13,
+    HEXCALC_ERR_INVALID_FRACTION_DIGIT = 14,
+    HEXCALC_ERR_INVALID_HEX_FLOAT = 15,
+    HEXCALC_ERR_INVALID_BYTE_LITERAL = 16,
+    HEXCALC_ERR_DIVISION_BY_ZERO = 17,
+    HEXCALC_ERR_MODULO_BY_ZERO = 18,
+    HEXCALC_ERR_ZERO_TO_NEGATIVE_POWER = 19,
+    HEXCALC_ERR_NEGATIVE_BASE_NON_INTEGER = 20,
+    HEXCALC_ERR_INTEGER_REQUIRED = 21,
+    HEXCALC_ERR_SHIFT_OUT_OF_RANGE = 22,
+    HEXCALC_ERR_FACTORIAL_OF_NEGATIVE = 23,
+    HEXCALC_ERR_FACTORIAL_OVERFLOW = 24,
+    HEXCALC_ERR_MATH_OVERFLOW = 25,
+    HEXCALC_ERR_BYTE_INTEGER_REQUIRED = 26,
+    HEXCALC_ERR_BYTE_OPERAND_OUT_OF_RANGE = 27,
+    HEXCALC_ERR_AMOUNT_NOT_NUMBER = 28,
+    HEXCALC_ERR_UNSUPPORTED_IN_BYTE_EXPR = 29,
+    HEXCALC_ERR_UNSUPPORTED_ON_BYTES = 30,
+    HEXCALC_ERR_NOT_BYTE_RESULT = 31,
+    HEXCALC_ERR_FILE_OPEN_FAILED = 32,
+    HEXCALC_ERR_FILE_MAP_FAILED = 33,
+    HEXCALC_ERR_WRITE_FAILED = 34,
+    HEXCALC_ERR_BYTES_NOT_SOLVABLE = 35,
+    HEXCALC_ERR_CONSTANT_NOT_INTEGER = 36,
+    HEXCALC_ERR_CONSTANT_TOO_LARGE = 37,
+    HEXCALC_ERR_INVALID_TOKEN = 38,
+    HEXCALC_ERR_INVALID_MODULUS = 39,
+    HEXCALC_ERR_MODULUS_NOT_CONSTANT = 40,
+    HEXCALC_ERR_MODULUS_REQUIRED = 41,
+    HEXCALC_ERR_UNSUPPORTED_IN_MOD_MODE = 42,
+    HEXCALC_ERR_NOT_INVERTIBLE = 43,
+    HEXCALC_ERR_EXPONENT_NOT_CONSTANT = 44,
+    HEXCALC_ERR_MOD_OPERAND_NOT_INTEGER = 45,
+    HEXCALC_ERR_INVALID_LIBRARY = 46,
+    HEXCALC_ERR_UNSUPPORTED_LIBRARY_VERSION = 47,
+    HEXCALC_ERR_DUPLICATE_PROGRAM_NAME = 48,
+    HEXCALC_ERR_NOT_COMPILABLE = 49,
+    HEXCALC_ERR_OUT_OF_MEMORY = 50
+};
+
+/* 错误码加上出错 token 在 expr 中的字节区间, length 为 0 表示没有具体位置 */
+typedef struct hexcalc_error {
+    int code;                   /* hexcalc_error_code */
+    size_t offset;
+    size_t length;
+} hexcalc_error;
+
+/* 批量计算的一项, out 可以指向同一块大缓冲区的不同位置 */
+typedef struct hexcalc_job {
+    const char *expr;
+    size_t expr_len;
+    char *out;
+    size_t out_cap;
+    size_t out_len;             /* 输出: 完整文本长度, >= out_cap 表示被截断 */
+    int status;                 /* 输出: hexcalc_status */
+} hexcalc_job;
+
+/* 字节数组结果的分块回调, 返回非 0 表示写入失败 */
+typedef int (*hexcalc_sink)(void *ctx, const uint8_t *data, size_t len);
+
+HEXCALC_API int hexcalc_abi_version(void);
+
+HEXCALC_API hexcalc_engine *hexcalc_create(void);
+HEXCALC_API void hexcalc_destroy(hexcalc_engine *engine);
+
+/* 当前构建不支持该后端时返回 HEXCALC_INVALID_ARGUMENT */
+HEXCALC_API int hexcalc_set_backend(hexcalc_engine *engine, int backend);
+
+HEXCALC_API int hexcalc_eval(hexcalc_engine *engine, const char *expr, size_t expr_len,
+                             char *out, size_t out_cap, size_t *out_len);
+
+/* 一次调用计算 count 个表达式, 返回失败的个数 */
+HEXCALC_API size_t hexcalc_eval_batch(hexcalc_engine *engine, hexcalc_job *jobs, size_t count);
+
+/* 同 hexcalc_eval, 但失败时不生成错误信息: out 为空串, 错误码和位置写入 err */
+HEXCALC_API int hexcalc_eval_ex(hexcalc_engine *engine, const char *expr, size_t expr_len,
+                                char *out, size_t out_cap, size_t *out_len, hexcalc_error *err);
+
+/* 同 hexcalc_eval_batch, errors 与 jobs 一一对应, 适合大部分输入都可能出错的批量计算 */
+HEXCALC_API size_t hexcalc_eval_batch_ex(hexcalc_engine *engine, hexcalc_job *jobs, hexcalc_error *errors, size_t count);
+
+/* 按需生成错误信息, expr 为出错时的表达式; 返回完整长度 */
+HEXCALC_API size_t hexcalc_error_message(const hexcalc_error *err, const char *expr, size_t expr_len,
+                                         char *out, size_t out_cap);
+
+/* 字节数组结果分块交给 sink, 错误信息写入 err */
+HEXCALC_API int hexcalc_write_bytes(hexcalc_engine *engine, const char *expr, size_t expr_len,
+                                    hexcalc_sink sink, void *ctx, int64_t *written,
+                                    char *err, size_t err_cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEXCALC_H */
@@ -0,0 +1,1123 @@
+#include "hexengine.h"
+#include "bitops.h"
+#include "numericbackend.h"
+#include "hexscan.h"
+#include "hexsyntax.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace {
+
+// 字节数组结果最多预览的字节数
+constexpr std::int64_t kBytesPreviewLimit = 256;
+
+// 按 snprintf 的方式截断复制, 返回完整长度
+std::size_t copyOut(const std::string &s, char *out, std::size_t cap){
+    if (cap > 0){
+        const std::size_t n = std::min(s.size(), cap - 1);
+        std::memcpy(out, s.data(), n);
+        out[n] = '\0';
+    }
+    return s.size();
+}
+
+bool isUnaryKeyword(std::string_view op){
+    KeywordKind kind;
+    findKeyword(op, kind);
+    return kind == KeywordKind::Unary;
+}
+
+// 记录错误码和位置后返回 false
+bool fail(HexError &err, HexErrorCode code, std::size_t offset = 0, std::size_t length = 0){
+    err = { code, offset, length };
+    return false;
+}
+
+template <typename T>
+bool failAt(HexError &err, HexErrorCode code, const T &token){
+    return fail(err, code, token.offset, token.length);
+}
+
+// 64 位字上的一元 / 二元位操作, op 不是位操作关键字时返回 false
+bool wordUnary(std::string_view op, std::uint64_t x, std::uint64_t &out){
+    if (op == "POPCNT") out = static_cast<std::uint64_t>(bitPopcount(x));
+    else if (op == "CLZ") out = static_cast<std::uint64_t>(bitClz(x));
+    else if (op == "CTZ") out = static_cast<std::uint64_t>(bitCtz(x));
+    else if (op == "PARITY") out = static_cast<std::uint64_t>(bitParity(x));
+    else if (op == "BSWAP") out = bitBswap(x);
+    else if (op == "BITREV") out = bitReverse(x);
+    else return false;
+    return true;
+}
+
+bool wordBinary(std::string_view op, std::uint64_t a, std::uint64_t b, std::uint64_t &out){
+    if (op == "ROL") out = bitRol(a, static_cast<unsigned>(b));
+    else if (op == "ROR") out = bitRor(a, static_cast<unsigned>(b));
+    else if (op == "PEXT") out = bitPext(a, b);
+    else if (op == "PDEP") out = bitPdep(a, b);
+    else return false;
+    return true;
+}
+
+// 负数按补码, 超过 long long 的非负整数 (如 FFFFFFFFFFFFFFFF) 直接取无符号值
+template <typename B>
+bool toWord(typename B::Value v, std::uint64_t &out){
+    long long intVal = 0;
+    if (B::toInt(v, intVal)){
+        out = static_cast<std::uint64_t>(intVal);
+        return true;
+    }
+    if (B::isNaN(v) || B::isInf(v) || B::isNeg(v) || B::exceedsU64(v)) return false;
+    out = B::toU64(v);
+    return B::isZero(v - B::fromU64(out));
+}
+
+// 位操作的结果按无符号字输出, 定点数放不下最高位时按补码输出
+template <typename B>
+typename B::Value fromWord(std::uint64_t w){
+    const typename B::Value v = B::fromU64(w);
+    return B::isInf(v) ? B::fromInt(static_cast<long long>(w)) : v;
+}
+
+} // namespace
+
+HexEngine::Result HexEngine::compute(std::string_view expr, char *out, std::size_t cap){
+    HexError err;
+    m_text.clear();
+    const bool ok = compute(expr, m_text, err);
+    if (!ok) formatError(err, expr, m_text);
+    return { !ok, copyOut(m_text, out, cap), err };
+}
+
+bool HexEngine::compute(std::string_view expr, std::string &out){
+    HexError err;
+    out.clear();
+    if (compute(expr, out, err)) return true;
+    out.clear();
+    formatError(err, expr, out);
+    return false;
+}
+
+bool HexEngine::compute(std::string_view expr, std::string &out, HexError &err){
+    if (!parse(expr, err)) return false;
+    if (const Token *v = findVariable(m_rpn)) return failAt(err, HexErrorCode::UnknownVariable, *v);
+
+    if (hasByteOperands(m_rpn)){
+        ByteExpr::Ptr bytes;
+        long long scalar = 0;
+        if (!evalBytes(m_rpn, bytes, scalar, err)) return false;
+        // POPCNT 等归约运算的结果是普通整数
+        out.clear();
+        if (bytes) bytes->appendHexPreview(kBytesPreviewLimit, out);
+        else formatHex<LongDoubleBackend>(static_cast<long double>(scalar), 0, out);
+        return true;
+    }
+
+    if (findModular(m_rpn)) return computeModular(m_rpn, out, err);
+
+    switch (m_backend){
+    case Backend::Double:
+        return computeWith<DoubleBackend>(m_rpn, out, err);
+#ifdef HEXCALC_HAS_FLOAT128
+    case Backend::Float128:
+        return computeWith<Float128Backend>(m_rpn, out, err);
+#endif
+    case Backend::Fixed64:
+        return computeWith<Fixed64Backend>(m_rpn, out, err);
+    default:
+        return computeWith<LongDoubleBackend>(m_rpn, out, err);
+    }
+}
+
+bool HexEngine::writeBytes(std::string_view expr, const ByteExpr::Sink &sink, std::int64_t &written, HexError &err){
+    written = 0;
+    if (!parse(expr, err)) return false;
+    if (const Token *v = findVariable(m_rpn)) return failAt(err, HexErrorCode::UnknownVariable, *v);
+    if (!hasByteOperands(m_rpn)) return fail(err, HexErrorCode::NotByteResult);
+
+    ByteExpr::Ptr bytes;
+    long long scalar = 0;
+    if (!evalBytes(m_rpn, bytes, scalar, err)) return false;
+    if (!bytes) return fail(err, HexErrorCode::NotByteResult);
+    if (!bytes->writeTo(sink)) return fail(err, HexErrorCode::WriteFailed);
+
+    written = std::max<std::int64_t>(bytes->size(), 0);
+    return true;
+}
+
+void HexEngine::formatError(const HexError &err, std::string_view expr, std::string &out){
+    // 位置越界时 (表达式已经变了) 不带 token 文字
+    const std::string_view token = err.offset <= expr.size() ? expr.substr(err.offset, err.length) : std::string_view();
+    auto quoted = [&out, token](const char *prefix, const char *suffix){
+        out += prefix;
+        out += token;
+        out += suffix;
+    };
+
+    switch (err.code){
+    case HexErrorCode::None: break;
+    case HexErrorCode::EmptyExpression: out += "empty expression"; break;
+    case HexErrorCode::UnexpectedChar: quoted("unexpected char '", "'"); break;
+    case HexErrorCode::InvalidOperator:
+        quoted("invalid operator '", "', did you mean '");
+        out += token;
+        out += token;
+        out += "'?";
+        break;
+    case HexErrorCode::InvalidNumber: quoted("invalid number '", "'"); break;
+    case HexErrorCode::EmptyByteLiteral: out += "empty byte array literal"; break;
+    case HexErrorCode::UnterminatedFileName: out += "unterminated file name"; break;
+    case HexErrorCode::MismatchedParentheses: out += "mismatched parentheses"; break;
+    case HexErrorCode::NotEnoughOperands: out += "not enough operands"; break;
+    case HexErrorCode::NotEnoughOperandsUnary:
+        out += "not enough operands for ";
+        out += token == "~" ? "bitwise NOT" : token == "!" ? "factorial" : token;
+        break;
+    case HexErrorCode::InvalidExpression: out += "invalid expression"; break;
+    case HexErrorCode::UnknownOperator: quoted("unknown operator ", ""); break;
+    case HexErrorCode::UnknownVariable: quoted("unknown variable '", "'"); break;
+    case HexErrorCode::InvalidIntegerDigit: out += "invalid digit in integer part"; break;
+    case HexErrorCode::InvalidFractionDigit: out += "invalid digit in fractional part"; break;
+    case HexErrorCode::InvalidHexFloat: out += "invalid hex float"; break;
+    case HexErrorCode::InvalidByteLiteral: out += "invalid digit in byte array literal"; break;
+    case HexErrorCode::DivisionByZero: out += "division by zero"; break;
+    case HexErrorCode::ModuloByZero: out += "modulo by zero"; break;
+    case HexErrorCode::ZeroToNegativePower: out += "zero to negative power"; break;
+    case HexErrorCode::NegativeBaseNonInteger: out += "negative base with non-integer exponent"; break;
+    case HexErrorCode::IntegerRequired:
+        if (token == "~") out += "bitwise NOT requires integer";
+        else if (token == "!") out += "factorial requires integer";
+        else if (isUnaryKeyword(token)) quoted("", " requires integer");
+        else out += "bitwise operations require integers";
+        break;
+    case HexErrorCode::ShiftOutOfRange: out += "shift amount out of range"; break;
+    case HexErrorCode::FactorialOfNegative: out += "factorial of negative number"; break;
+    case HexErrorCode::FactorialOverflow: out += "factorial overflow"; break;
+    case HexErrorCode::MathOverflow: out += "Factorial/Math Overflow"; break;
+    case HexErrorCode::ByteIntegerRequired: out += "byte array expressions require integers"; break;
+    case HexErrorCode::ByteOperandOutOfRange: out += "byte array operand must be between 0 and FF"; break;
+    case HexErrorCode::AmountNotNumber:
+        out += token == "ROL" || token == "ROR" ? "rotate amount must be a number" : "shift amount must be a number";
+        break;
+    case HexErrorCode::UnsupportedInByteExpr: quoted("operator '", "' is not supported in byte array expressions"); break;
+    case HexErrorCode::UnsupportedOnBytes: quoted("operator '", "' is not supported on byte arrays"); break;
+    case HexErrorCode::NotByteResult: out += "only byte array results can be written to a file"; break;
+    case HexErrorCode::FileOpenFailed: quoted("cannot open '", "'"); break;
+    case HexErrorCode::FileMapFailed: quoted("cannot map '", "'"); break;
+    case HexErrorCode::WriteFailed: out += "write failed"; break;
+    case HexErrorCode::BytesNotSolvable: out += "byte arrays are not supported when solving"; break;
+    case HexErrorCode::ConstantNotInteger: out += "solver requires integer constants"; break;
+    case HexErrorCode::ConstantTooLarge: out += "constant does not fit in a signed 64-bit integer"; break;
+    case HexErrorCode::InvalidToken: out += "invalid token in rpn"; break;
+    case HexErrorCode::InvalidModulus: out += "modulus must be an integer >= 2"; break;
+    case HexErrorCode::ModulusNotConstant: out += "MOD must be the outermost operator with a constant modulus"; break;
+    case HexErrorCode::ModulusRequired: quoted("", " requires a MOD modulus"); break;
+    case HexErrorCode::UnsupportedInModMode: quoted("'", "' is not supported with MOD"); break;
+    case HexErrorCode::NotInvertible: out += "not invertible modulo the modulus"; break;
+    case HexErrorCode::ExponentNotConstant: out += "exponent must be a constant with MOD"; break;
+    case HexErrorCode::ModOperandNotInteger: out += "operands must be integers with MOD"; break;
+    case HexErrorCode::InvalidLibrary: out += "invalid program library"; break;
+    case HexErrorCode::UnsupportedLibraryVersion: out += "unsupported program library version"; break;
+    case HexErrorCode::DuplicateProgramName: out += "duplicate program name"; break;
+    case HexErrorCode::OutOfMemory: out += "out of memory"; break;
+    case HexErrorCode::NotCompilable: quoted("'", "' cannot be compiled, programs only hold 64-bit integer expressions"); break;
+    }
+}
+
+bool HexEngine::compile(std::string_view expr, Program &out, HexError &err){
+    out = Program();
+    if (!parse(expr, err)) return false;
+
+    std::uint32_t depth = 0;
+    for (const auto &t : m_rpn){
+        switch (t.type){
+        case TokType::Number: {
+            std::int64_t v = 0;
+            HexErrorCode code = HexErrorCode::None;
+            if (!parseInt64(t.text, v, code)) return failAt(err, code, t);
+            out.emit(Program::Op::Const, static_cast<std::uint32_t>(out.consts.size()));
+            out.consts.push_back(v);
+            depth++;
+            break;
+        }
+        case TokType::Variable: {
+            const auto it = std::find(out.vars.begin(), out.vars.end(), t.text);
+            out.emit(Program::Op::Var, static_cast<std::uint32_t>(it - out.vars.begin()));
+            if (it == out.vars.end()) out.vars.emplace_back(t.text);
+            depth++;
+            break;
+        }
+        case TokType::Bytes:
+        case TokType::File:
+            return failAt(err, HexErrorCode::NotCompilable, t);
+        case TokType::UnaryPreOp:
+        case TokType::UnaryPostOp: {
+            if (depth < 1) return failAt(err, HexErrorCode::NotEnoughOperandsUnary, t);
+            Program::Op op;
+            if (t.text == "~") op = Program::Op::Not;
+            else if (t.text == "!") op = Program::Op::Fact;
+            else if (t.text == "POPCNT") op = Program::Op::Popcnt;
+            else if (t.text == "CLZ") op = Program::Op::Clz;
+            else if (t.text == "CTZ") op = Program::Op::Ctz;
+            else if (t.text == "PARITY") op = Program::Op::Parity;
+            else if (t.text == "BSWAP") op = Program::Op::Bswap;
+            else if (t.text == "BITREV") op = Program::Op::Bitrev;
+            else return failAt(err, HexErrorCode::NotCompilable, t);
+            out.emit(op);
+            break;
+        }
+        case TokType::Op: {
+            if (depth < 2) return failAt(err, HexErrorCode::NotEnoughOperands, t);
+            depth--;
+            Program::Op op;
+            if (t.text == "+") op = Program::Op::Add;
+            else if (t.text == "-") op = Program::Op::Sub;
+            else if (t.text == "*") op = Program::Op::Mul;
+            else if (t.text == "/") op = Program::Op::Div;
+            else if (t.text == "%") op = Program::Op::Mod;
+            else if (t.text == "^") op = Program::Op::Pow;
+            else if (t.text == "&") op = Program::Op::And;
+            else if (t.text == "|") op = Program::Op::Or;
+            else if (t.text == "^^") op = Program::Op::Xor;
+            else if (t.text == "<<") op = Program::Op::Shl;
+            else if (t.text == ">>") op = Program::Op::Shr;
+            else if (t.text == "ROL") op = Program::Op::Rol;
+            else if (t.text == "ROR") op = Program::Op::Ror;
+            else if (t.text == "PEXT") op = Program::Op::Pext;
+            else if (t.text == "PDEP") op = Program::Op::Pdep;
+            else return failAt(err, HexErrorCode::NotCompilable, t);
+            out.emit(op);
+            break;
+        }
+        default:
+            return failAt(err, HexErrorCode::InvalidToken, t);
+        }
+        out.maxDepth = std::max(out.maxDepth, depth);
+    }
+
+    if (depth != 1) return fail(err, HexErrorCode::InvalidExpression);
+    return true;
+}
+
+bool HexEngine::parse(std::string_view expression, HexError &err){
+    if (!tokenize(expression, m_tokens, err)) return false;
+    return toRpn(m_tokens, m_rpn, err);
+}
+
+template <typename B>
+bool HexEngine::computeWith(const std::vector<Token> &rpn, std::string &out, HexError &err){
+    typename B::Value v = B::fromInt(0);
+    if (!evalRpn<B>(rpn, v, err)) return false;
+    if (B::isInf(v)) return fail(err, HexErrorCode::MathOverflow);
+
+    out.clear();
+    formatHex<B>(v, B::fracDigits, out);
+    return true;
+}
+
+bool HexEngine::backendAvailable(Backend backend){
+#ifndef HEXCALC_HAS_FLOAT128
+    if (backend == Backend::Float128) return false;
+#endif
+    return backend == Backend::Double || backend == Backend::LongDouble
+        || backend == Backend::Float128 || backend == Backend::Fixed64;
+}
+
+const char *HexEngine::backendName(Backend backend){
+    switch (backend){
+    case Backend::Double: return DoubleBackend::name;
+    case Backend::LongDouble: return LongDoubleBackend::name;
+    case Backend::Float128: return "float128";
+    case Backend::Fixed64: return Fixed64Backend::name;
+    }
+    return "";
+}
+
+bool HexEngine::backendFromName(std::string_view name, Backend &out){
+    while (!name.empty() && isExprSpace(name.front())) name.remove_prefix(1);
+    while (!name.empty() && isExprSpace(name.back())) name.remove_suffix(1);
+
+    std::string n(name);
+    for (char &c : n){
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+
+    if (n == DoubleBackend::name) out = Backend::Double;
+    else if (n == LongDoubleBackend::name) out = Backend::LongDouble;
+#ifdef HEXCALC_HAS_FLOAT128
+    else if (n == Float128Backend::name) out = Backend::Float128;
+#endif
+    else if (n == Fixed64Backend::name) out = Backend::Fixed64;
+    else return false;
+    return true;
+}
+
+template <typename B>
+typename B::Value HexEngine::fastPow(typename B::Value base, long long exp){
+    bool negExp = exp < 0;
+    if (negExp) exp = -exp;
+
+    typename B::Value result = B::fromInt(1);
+    while (exp > 0) {
+        if (exp & 1) {          // 二进制最低位为1
+            result = result * base;
+        }
+        base = base * base;     // base 自乘
+        exp >>= 1;              // 右移一位
+    }
+    return negExp ? (B::fromInt(1) / result) : result;
+}
+
+// 通用幂运算 - 整数指数用快速幂，非整数用标准库
+template <typename B>
+typename B::Value HexEngine::safePow(typename B::Value a, typename B::Value b){
+    long long intExp = 0;
+    if (B::toInt(b, intExp) && std::abs(intExp) < 64){
+        return fastPow<B>(a, intExp);  // 整数快速幂
+    }
+    return B::pow(a, b);               // 非整数标准库
+}
+
+template <typename B>
+typename B::Value HexEngine::factorial(long long n){
+    if (n < 0) return B::nan();
+    if (n > 22) return B::inf();
+    if (n <= 1) return B::fromInt(1);
+    typename B::Value result = B::fromInt(1);
+    for (long long i = 1; i <= n; ++i){
+        result = result * B::fromInt(i);
+        if (B::isInf(result) || B::isNeg(result) || B::isZero(result)){
+            return B::inf();
+        }
+    }
+    return result;
+}
+
+namespace {
+
+// 按 16 个字符一组转换成 64 位字, 高位在前依次回调 fn(word, digitCount)
+// 最前面不足 16 位的部分单独处理
+template <typename Fn>
+bool forEachHexWord(const char *p, std::size_t n, Fn fn){
+    const std::size_t head = n % 16;
+    if (head > 0){
+        std::uint64_t w = 0;
+        if (!hexToWord(p, head, w)) return false;
+        fn(w, static_cast<int>(head));
+        p += head;
+        n -= head;
+    }
+
+    std::uint64_t words[32];
+    while (n > 0){
+        const std::size_t chunk = std::min<std::size_t>(n, 16 * 32);
+        const std::size_t count = hexToWords(p, chunk, words);
+        for (std::size_t k = 0; k < count; k++) fn(words[k], 16);
+        if (count * 16 != chunk) return false;
+        p += chunk;
+        n -= chunk;
+    }
+    return true;
+}
+
+} // namespace
+
+template <typename B>
+bool HexEngine::parseHexFloat(std::string_view s, typename B::Value &out, HexErrorCode &err){
+    // 按后端精度转换, 浮点后端为近似值
+    const char *p = s.data();
+    std::size_t n = s.size();
+
+    bool neg = false;
+    if (n > 0 && (p[0] == '+' || p[0] == '-')){
+        neg = p[0] == '-';
+        p++;
+        n--;
+    }
+
+    const char *dot = static_cast<const char *>(std::memchr(p, '.', n));
+    const std::size_t intLen = dot ? static_cast<std::size_t>(dot - p) : n;
+    const std::size_t fracLen = dot ? n - intLen - 1 : 0;
+    if (dot && std::memchr(dot + 1, '.', fracLen)) { err = HexErrorCode::InvalidHexFloat; return false; }
+
+    // 整数部分: intPart = intPart * 16^k + word
+    typename B::Value intPart = B::fromInt(0);
+    const bool intOk = forEachHexWord(p, intLen, [&intPart](std::uint64_t w, int digits){
+        intPart = B::ldexp(intPart, 4 * digits) + B::fromU64(w);
+    });
+    if (!intOk){
+        err = HexErrorCode::InvalidIntegerDigit;
+        return false;
+    }
+
+    // 小数部分: fracPart += word * 16^-(已处理位数)
+    typename B::Value fracPart = B::fromInt(0);
+    if (dot){
+        int pos = 0;
+        const bool fracOk = forEachHexWord(dot + 1, fracLen, [&fracPart, &pos](std::uint64_t w, int digits){
+            pos += digits;
+            fracPart = fracPart + B::fromU64Exp(w, -4 * pos);
+        });
+        if (!fracOk){
+            err = HexErrorCode::InvalidFractionDigit;
+            return false;
+        }
+    }
+
+    out = intPart + fracPart;
+    if (neg) out = -out;
+    return true;
+}
+
+void HexEngine::toHexFloatString(long double v, int fracDigits, std::string &out){
+    formatHex<LongDoubleBackend>(v, fracDigits, out);
+}
+
+template <typename B>
+void HexEngine::formatHex(typename B::Value v, int fracDigits, std::string &out){
+    static const char digits[] = "0123456789ABCDEF";
+
+    if (B::isNaN(v)){
+        out += "NAN";
+        return;
+    }
+    if (B::isInf(v)){
+        out += B::isNeg(v) ? "-INF" : "INF";
+        return;
+    }
+
+    const typename B::Value orig = v;
+    bool neg = B::isNeg(v);
+    if (neg) v = -v;
+
+    std::uint64_t intPart = 0;
+    typename B::Value frac = B::fromInt(0);
+    if (B::isInf(v)){
+        // 只有定点数的最小值 -2^63 取反会溢出, 它没有小数部分, 用无符号数取绝对值
+        intPart = std::uint64_t(0) - B::toU64(orig);
+    } else if (B::exceedsU64(v)){
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.15g", static_cast<double>(B::toLongDouble(orig)));
+        out += buf;
+        return;
+    } else {
+        intPart = B::toU64(v);
+        frac = v - B::fromU64(intPart);
+    }
+    const typename B::Value sixteen = B::fromInt(16);
+
+    // 整数部分最多 16 位, 从低位往前填
+    char intBuf[16];
+    int intLen = 0;
+    do {
+        intBuf[15 - intLen++] = digits[intPart & 0xF];
+        intPart >>= 4;
+    } while (intPart != 0);
+
+    if (neg) out += '-';
+    out.append(intBuf + 16 - intLen, static_cast<std::size_t>(intLen));
+
+    const std::size_t fracStart = out.size() + 1;
+    out += '.';
+    for (int i = 0; i < fracDigits; i++){
+        frac = frac * sixteen;
+        int digit = static_cast<int>(B::toU64(frac));
+
+        if (digit < 0) digit = 0;
+        if (digit > 15) digit = 15;
+
+        frac = frac - B::fromInt(digit);
+        out += digits[digit];
+        if (B::isZero(frac)) break;
+    }
+
+    while (out.size() > fracStart && out.back() == '0') out.pop_back();
+    if (out.size() == fracStart) out.pop_back();
+}
+
+bool HexEngine::tokenize(std::string_view expr, std::vector<Token> &outTokens, HexError &err) const{
+    outTokens.clear();
+    if (expr.empty()) return fail(err, HexErrorCode::EmptyExpression);
+
+    const std::size_t size = expr.size();
+    std::size_t i = 0;
+
+    while (i < size){
+        const char c = expr[i];
+
+        if (isExprSpace(c)){
+            i++;
+            continue;
+        }
+        if (c == '('){
+            outTokens.push_back({TokType::LParen, "(", i, 1});
+            i++;
+            continue;
+        }
+        if (c == ')'){
+            outTokens.push_back({TokType::RParen, ")", i, 1});
+            i++;
+            continue;
+        }
+        if (c == '!'){
+            outTokens.push_back({TokType:: UnaryPostOp, "!", i, 1});
+            i++;
+            continue;
+        }
+        if (c == '~'){
+            outTokens.push_back({TokType:: UnaryPreOp, "~", i, 1});
+            i++;
+            continue;
+        }
+        if (c == '#'){
+            const std::size_t start = i + 1;
+            i = start + hexRunLength(expr.data() + start, size - start);
+            if (i == start) return fail(err, HexErrorCode::EmptyByteLiteral, start - 1, 1);
+            outTokens.push_back({TokType::Bytes, expr.substr(start, i - start), start - 1, i - start + 1});
+            continue;
+        }
+        if (c == '"'){
+            const std::size_t end = expr.find('"', i + 1);
+            if (end == std::string_view::npos) return fail(err, HexErrorCode::UnterminatedFileName, i, size - i);
+            // 位置只包含引号内的路径, 报错时直接引用
+            outTokens.push_back({TokType::File, expr.substr(i + 1, end - i - 1), i + 1, end - i - 1});
+            i = end + 1;
+            continue;
+        }
+        if (c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || c == '&' || c == '|'){
+            outTokens.push_back({TokType::Op, expr.substr(i, 1), i, 1});
+            i++;
+            continue;
+        }
+        if (c == '^' || c == '<' || c == '>'){
+            std::size_t j = i + 1;
+            while (j < size && isExprSpace(expr[j])) j++;
+
+            if (j < size && expr[j] == c){
+                outTokens.push_back({TokType::Op, c == '^' ? "^^" : c == '<' ? "<<" : ">>", i, j + 1 - i});
+                i = j + 1;
+            } else if (c == '^'){
+                outTokens. push_back({TokType::Op, "^", i, 1});
+                i++;
+            } else {
+                return fail(err, HexErrorCode::InvalidOperator, i, 1);
+            }
+            continue;
+        }
+        if ((c >= 'A' && c <= 'Z') || c == '_'){
+            std::size_t end = i;
+            while (end < size && isWordChar(expr[end])) end++;
+            const std::string_view word = expr.substr(i, end - i);
+
+            // 关键字优先于十六进制数 (CLZ / BSWAP 以十六进制字母开头)
+            KeywordKind kind;
+            findKeyword(word, kind);
+            if (kind != KeywordKind::None){
+                outTokens.push_back({kind == KeywordKind::Binary ? TokType::Op : TokType::UnaryPreOp, word, i, word.size()});
+                i = end;
+                continue;
+            }
+            if (!isHexDigit(c)){
+                outTokens.push_back({TokType::Variable, word, i, word.size()});
+                i = end;
+                continue;
+            }
+        }
+        if (isHexDigit(c) || c == '.'){
+            const std::size_t start = i;
+            bool seenDot = false;
+
+            while (i < size){
+                i += hexRunLength(expr.data() + i, size - i);
+                if (i < size && expr[i] == '.' && !seenDot){
+                    seenDot = true;
+                    i++;
+                    continue;
+                }
+                break;
+            }
+
+            const std::string_view num = expr.substr(start, i - start);
+            if (num == ".") return fail(err, HexErrorCode::InvalidNumber, start, 1);
+
+            outTokens.push_back({TokType::Number, num, start, num.size()});
+            continue;
+        }
+
+        // 非 ASCII 字符按整个 UTF-8 序列报错
+        const unsigned char u = static_cast<unsigned char>(c);
+        const std::size_t len = u >= 0xF0 ? 4 : u >= 0xE0 ? 3 : u >= 0xC0 ? 2 : 1;
+        return fail(err, HexErrorCode::UnexpectedChar, i, std::min(len, size - i));
+    }
+
+    return true;
+}
+
+
+bool HexEngine::toRpn(const std::vector<Token> &tokens, std::vector<Token> &outRpn, HexError &err){
+    outRpn.clear();
+    std::vector<Token> &opStack = m_opStack;
+    opStack.clear();
+
+    for (const auto &t : tokens){
+        if (t.type == TokType::Number || t.type == TokType::Bytes || t.type == TokType::File || t.type == TokType::Variable){
+            outRpn.push_back(t);
+
+            while (!opStack.empty() && opStack.back().type == TokType::UnaryPreOp){
+                outRpn.push_back(opStack.back());
+                opStack.pop_back();
+            }
+
+            continue;
+        }
+        if (t. type == TokType::UnaryPreOp){
+            opStack.push_back(t);
+            continue;
+        }
+
+        if (t.type == TokType::Op){
+            while (!opStack.empty()){
+                const Token top = opStack.back();
+                if (top.type != TokType::Op) break;
+
+                const int p1 = operatorPrecedence(t.text);
+                const int p2 = operatorPrecedence(top.text);
+
+                if ((isLeftAssociative(t.text) && p1 <= p2) || (!isLeftAssociative(t.text) && p1 < p2)) {
+                    outRpn.push_back(top);
+                    opStack.pop_back();
+                } else {
+                    break;
+                }
+            }
+            opStack.push_back(t);
+            continue;
+        }
+        if (t.type == TokType::UnaryPostOp){
+            outRpn.push_back(t);
+            continue;
+        }
+
+        if (t.type == TokType::LParen){
+            opStack.push_back(t);
+            continue;
+        }
+
+        if (t.type == TokType::RParen){
+            bool matched = false;
+            while (!opStack.empty()){
+                const Token top = opStack.back();
+                opStack.pop_back();
+                if (top.type == TokType::LParen){
+                    matched = true;
+                    break;
+                }
+                outRpn.push_back(top);
+            }
+            if (!matched) return failAt(err, HexErrorCode::MismatchedParentheses, t);
+            // 括号整体是前缀运算符的操作数, 例如 ~(1) + 2 / POPCNT(X) + 1
+            while (!opStack.empty() && opStack.back().type == TokType::UnaryPreOp){
+                outRpn.push_back(opStack.back());
+                opStack.pop_back();
+            }
+            continue;
+        }
+    }
+
+    while (!opStack.empty()){
+        const Token top = opStack.back();
+        opStack.pop_back();
+        if (top.type == TokType::LParen || top.type == TokType::RParen) return failAt(err, HexErrorCode::MismatchedParentheses, top);
+        outRpn.push_back(top);
+    }
+
+    return true;
+}
+
+template <typename B>
+bool HexEngine::evalRpn(const std::vector<Token> &rpn, typename B::Value &outValue, HexError &err){
+    using Value = typename B::Value;
+    static_assert(std::is_trivially_copyable<Value>::value && std::is_trivially_destructible<Value>::value
+                  && alignof(Value) <= alignof(std::max_align_t), "value stack uses raw storage");
+
+    // 每个 token 最多压入一个值, 栈深度不超过 rpn.size()
+    const std::size_t slots = (rpn.size() * sizeof(Value) + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    if (m_valueStack.size() < slots) m_valueStack.resize(slots);
+    Value *const st = reinterpret_cast<Value *>(m_valueStack.data());
+    std::size_t sp = 0;
+
+    auto push = [st, &sp](const Value &v){ new (st + sp++) Value(v); };
+    auto pop = [st, &sp](){ return st[--sp]; };
+
+    for (const auto &t : rpn){
+        if (t.type == TokType::Number){
+            Value v = B::fromInt(0);
+            HexErrorCode code = HexErrorCode::None;
+            if (!parseHexFloat<B>(t.text, v, code)) return failAt(err, code, t);
+            push(v);
+            continue;
+        }
+
+        if (t.type == TokType::UnaryPreOp){
+            if (sp < 1) return failAt(err, HexErrorCode::NotEnoughOperandsUnary, t);
+            const Value a = pop();
+
+            std::uint64_t x = 0;
+            if (!toWord<B>(a, x)) return failAt(err, HexErrorCode::IntegerRequired, t);
+            if (t. text == "~"){
+                // 与 & | ^^ 相同, 结果按有符号数输出: ~0 为 -1
+                push(B::fromInt(static_cast<long long>(~x)));
+            } else {
+                std::uint64_t r = 0;
+                if (!wordUnary(t.text, x, r)) return failAt(err, HexErrorCode::UnknownOperator, t);
+                push(fromWord<B>(r));
+            }
+            continue;
+        }
+        if (t.type == TokType::Op){
+            if (sp < 2) return failAt(err, HexErrorCode::NotEnoughOperands, t);
+            const Value b = pop();
+            const Value a = pop();
+
+            Value r = B::fromInt(0);
+            if (t.text == "+") r = a + b;
+            else if (t.text == "-") r = a - b;
+            else if (t.text == "*") r = a * b;
+            else if (t.text == "/") {
+                if (B::isZero(b)) return failAt(err, HexErrorCode::DivisionByZero, t);
+                r = a / b;
+            } else if (t.text == "%"){
+                if (B::isZero(b)) return failAt(err, HexErrorCode::ModuloByZero, t);
+                r = B::fmod(a, b);
+            } else if (t.text == "^"){
+                if (B::isZero(a) && B::isNeg(b)) return failAt(err, HexErrorCode::ZeroToNegativePower, t);
+                if (B::isNeg(a)){
+                    long long intExp = 0;
+                    if (!B::toInt(b, intExp)) return failAt(err, HexErrorCode::NegativeBaseNonInteger, t);
+                }
+                r = safePow<B>(a, b);
+            }  else if (t.text == "&" || t.text == "|" || t.text == "^^" || t.text == "<<" || t.text == ">>") {
+                // 位操作的结果可能超过 long long, 统一按 64 位补码参与运算
+                std::uint64_t wordA = 0;
+                std::uint64_t wordB = 0;
+                if (!toWord<B>(a, wordA) || !toWord<B>(b, wordB)) return failAt(err, HexErrorCode::IntegerRequired, t);
+                const long long intA = static_cast<long long>(wordA);
+                const long long intB = static_cast<long long>(wordB);
+
+                if (t.text == "&") {
+                    r = B::fromInt(intA & intB);
+                } else if (t.text == "|") {
+                    r = B::fromInt(intA | intB);
+                } else if (t.text == "^^") {
+                    r = B::fromInt(intA ^ intB);
+                } else if (t.text == "<<") {
+                    if (intB < 0 || intB > 63) return failAt(err, HexErrorCode::ShiftOutOfRange, t);
+                    // 负数左移是未定义行为, 按无符号字移位
+                    r = B::fromInt(static_cast<long long>(wordA << intB));
+                } else if (t. text == ">>") {
+                    if (intB < 0 || intB > 63) return failAt(err, HexErrorCode::ShiftOutOfRange, t);
+                    r = B::fromInt(intA >> intB);
+                }
+            } else if (t.text == "ROL" || t.text == "ROR" || t.text == "PEXT" || t.text == "PDEP"){
+                std::uint64_t wordA = 0;
+                std::uint64_t wordB = 0;
+                std::uint64_t w = 0;
+                if (!toWord<B>(a, wordA) || !toWord<B>(b, wordB)) return failAt(err, HexErrorCode::IntegerRequired, t);
+                wordBinary(t.text, wordA, wordB, w);
+                r = fromWord<B>(w);
+            } else {
+                return failAt(err, HexErrorCode::UnknownOperator, t);
+            }
+            push(r);
+            continue;
+        }
+        if (t.type == TokType::UnaryPostOp){
+            if (sp < 1) return failAt(err, HexErrorCode::NotEnoughOperandsUnary, t);
+            const Value a = pop();
+
+            if (t. text == "!"){
+                if (B::isNeg(a)) return failAt(err, HexErrorCode::FactorialOfNegative, t);
+                long long intVal = 0;
+                if (!B::toInt(a, intVal)) return failAt(err, HexErrorCode::IntegerRequired, t);
+                if (intVal > 22) return failAt(err, HexErrorCode::FactorialOverflow, t);
+                push(factorial<B>(intVal));
+            }
+            continue;
+        }
+
+        return failAt(err, HexErrorCode::InvalidToken, t);
+    }
+
+    if (sp != 1) return fail(err, HexErrorCode::InvalidExpression);
+
+    outValue = st[0];
+    return true;
+}
+
+bool HexEngine::hasByteOperands(const std::vector<Token> &rpn){
+    for (const auto &t : rpn){
+        if (t.type == TokType::Bytes || t.type == TokType::File) return true;
+    }
+    return false;
+}
+
+const HexEngine::Token *HexEngine::findVariable(const std::vector<Token> &rpn){
+    for (const auto &t : rpn){
+        if (t.type == TokType::Variable) return &t;
+    }
+    return nullptr;
+}
+
+const HexEngine::Token *HexEngine::findModular(const std::vector<Token> &rpn){
+    for (const auto &t : rpn){
+        if (t.text == "MOD" || t.text == "INV") return &t;
+    }
+    return nullptr;
+}
+
+bool HexEngine::computeModular(const std::vector<Token> &rpn, std::string &out, HexError &err){
+    // 只接受 "表达式 MOD N", N 为常数: 逆波兰的最后两个 token 就是 N 和 MOD
+    const std::size_t count = rpn.size();
+    const Token &last = rpn.back();
+    if (last.text != "MOD"){
+        const Token *m = findModular(rpn);
+        return failAt(err, m->text == "INV" ? HexErrorCode::ModulusRequired : HexErrorCode::ModulusNotConstant, *m);
+    }
+    if (count < 3) return failAt(err, HexErrorCode::NotEnoughOperands, last);
+    const Token &modulus = rpn[count - 2];
+    if (modulus.type != TokType::Number) return failAt(err, HexErrorCode::ModulusNotConstant, last);
+    if (modulus.text.find('.') != std::string_view::npos) return failAt(err, HexErrorCode::InvalidModulus, modulus);
+
+    if (modulus.text != m_modulus){
+        HexErrorCode code = HexErrorCode::None;
+        m_modulus.clear();
+        if (!m_mod.setModulus(modulus.text, code)) return failAt(err, code, modulus);
+        m_modulus.assign(modulus.text);
+    }
+
+    // 栈上每个值占 n 个字; literal 记录直接来自常数的值, 指数要用它的原值而不是余数
+    const std::size_t n = m_mod.limbs();
+    // 每个槽位压栈时都会写入, 只需保证容量
+    if (m_modStack.size() < (count - 2) * n) m_modStack.resize((count - 2) * n);
+    if (m_modLiteral.size() < count - 2) m_modLiteral.resize(count - 2);
+    std::vector<std::uint64_t> &st = m_modStack;
+    std::vector<const Token *> &literal = m_modLiteral;
+    std::vector<std::uint64_t> &exponent = m_exponent;
+    std::size_t sp = 0;
+    auto slot = [&st, n](std::size_t i){ return st.data() + i * n; };
+
+    for (std::size_t i = 0; i + 2 < count; i++){
+        const Token &t = rpn[i];
+
+        if (t.type == TokType::Number){
+            if (t.text.find('.') != std::string_view::npos) return failAt(err, HexErrorCode::ModOperandNotInteger, t);
+            HexErrorCode code = HexErrorCode::None;
+            if (!m_mod.fromHex(t.text, slot(sp), code)) return failAt(err, code, t);
+            literal[sp++] = &t;
+            continue;
+        }
+
+        if (t.type == TokType::UnaryPreOp && t.text == "INV"){
+            if (sp < 1) return failAt(err, HexErrorCode::NotEnoughOperandsUnary, t);
+            if (!m_mod.inverse(slot(sp - 1), slot(sp - 1))) return failAt(err, HexErrorCode::NotInvertible, t);
+            literal[sp - 1] = nullptr;
+            continue;
+        }
+
+        if (t.type == TokType::Op && (t.text == "+" || t.text == "-" || t.text == "*" || t.text == "/" || t.text == "^")){
+            if (sp < 2) return failAt(err, HexErrorCode::NotEnoughOperands, t);
+            std::uint64_t *a = slot(sp - 2);
+            std::uint64_t *b = slot(sp - 1);
+
+            if (t.text == "+") m_mod.add(a, b, a);
+            else if (t.text == "-") m_mod.sub(a, b, a);
+            else if (t.text == "*") m_mod.mul(a, b, a);
+            else if (t.text == "/"){
+                // 乘以逆元
+                if (!m_mod.inverse(b, b)) return failAt(err, HexErrorCode::NotInvertible, t);
+                m_mod.mul(a, b, a);
+            } else {
+                if (!literal[sp - 1]) return failAt(err, HexErrorCode::ExponentNotConstant, t);
+                HexErrorCode code = HexErrorCode::None;
+                if (!ModContext::parseHex(literal[sp - 1]->text, exponent, code)) return failAt(err, code, *literal[sp - 1]);
+                m_mod.pow(a, exponent.data(), exponent.size(), a);
+            }
+            sp--;
+            literal[sp - 1] = nullptr;
+            continue;
+        }
+
+        if (t.text == "MOD") return failAt(err, HexErrorCode::ModulusNotConstant, t);
+        return failAt(err, HexErrorCode::UnsupportedInModMode, t);
+    }
+
+    if (sp != 1) return fail(err, HexErrorCode::InvalidExpression);
+
+    out.clear();
+    m_mod.toHex(slot(0), out);
+    return true;
+}
+
+bool HexEngine::parseInt64(std::string_view s, std::int64_t &out, HexErrorCode &err){
+    // 小数部分只允许全 0; 计算器把超过 7FFFFFFFFFFFFFFF 的常量当作无符号数, 程序里表示不了
+    const std::size_t dot = s.find('.');
+    std::string_view digits = s.substr(0, dot);
+    if (dot != std::string_view::npos && s.find_first_not_of('0', dot + 1) != std::string_view::npos){
+        err = HexErrorCode::NotCompilable;
+        return false;
+    }
+    while (digits.size() > 1 && digits.front() == '0') digits.remove_prefix(1);
+    if (digits.size() > 16){
+        err = HexErrorCode::ConstantTooLarge;
+        return false;
+    }
+
+    std::uint64_t w = 0;
+    if (!digits.empty() && !hexToWord(digits.data(), digits.size(), w)){
+        err = HexErrorCode::InvalidIntegerDigit;
+        return false;
+    }
+    if (w > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())){
+        err = HexErrorCode::ConstantTooLarge;
+        return false;
+    }
+    out = static_cast<std::int64_t>(w);
+    return true;
+}
+
+bool HexEngine::evalBytes(const std::vector<Token> &rpn, ByteExpr::Ptr &out, long long &scalar, HexError &err){
+    using Operand = ByteOperand;
+    std::vector<Operand> &st = m_byteStack;
+    st.clear();
+    // 返回时清空, 栈上的字节数组 (可能映射着文件) 不留到下一次求值
+    struct ClearOnExit {
+        std::vector<Operand> &v;
+        ~ClearOnExit() { v.clear(); }
+    } clearOnExit { st };
+
+    auto pop = [&st](){
+        Operand o = std::move(st.back());
+        st.pop_back();
+        return o;
+    };
+
+    // 标量与字节数组做按位运算时按字节广播, 因此必须在 0..FF 之间, 否则返回 nullptr
+    auto toBytes = [](const Operand &o) -> ByteExpr::Ptr{
+        if (o.bytes) return o.bytes;
+        if (o.scalar < 0 || o.scalar > 0xFF) return nullptr;
+        return ByteExpr::broadcast(static_cast<std::uint8_t>(o.scalar));
+    };
+
+    for (const auto &t : rpn){
+        if (t.type == TokType::Number){
+            long double v = 0;
+            long long intVal = 0;
+            HexErrorCode code = HexErrorCode::None;
+            if (!parseHexFloat<LongDoubleBackend>(t.text, v, code)) return failAt(err, code, t);
+            if (!LongDoubleBackend::toInt(v, intVal)) return failAt(err, HexErrorCode::ByteIntegerRequired, t);
+            st.push_back({ nullptr, intVal });
+            continue;
+        }
+        if (t.type == TokType::Bytes || t.type == TokType::File){
+            HexErrorCode code = HexErrorCode::None;
+            ByteExpr::Ptr e = t.type == TokType::Bytes ? ByteExpr::fromHex(t.text, code)
+                                                       : ByteExpr::mapFile(std::string(t.text), code);
+            if (!e) return failAt(err, code, t);
+            st.push_back({ e, 0 });
+            continue;
+        }
+
+        if (t.type == TokType::UnaryPreOp){
+            if (st.size() < 1) return failAt(err, HexErrorCode::NotEnoughOperandsUnary, t);
+            Operand a = pop();
+            if (!a.bytes){
+                std::uint64_t r = 0;
+                if (t.text == "~") r = ~static_cast<std::uint64_t>(a.scalar);
+                else if (!wordUnary(t.text, static_cast<std::uint64_t>(a.scalar), r)) return failAt(err, HexErrorCode::UnsupportedInByteExpr, t);
+                st.push_back({ nullptr, static_cast<long long>(r) });
+                continue;
+            }
+
+            // 字节数组按一个 size * 8 位的大整数处理, 计数类运算的结果是标量
+            if (t.text == "~") st.push_back({ ByteExpr::complement(a.bytes), 0 });
+            else if (t.text == "BSWAP") st.push_back({ ByteExpr::reverse(ByteExpr::Kind::Reverse, a.bytes), 0 });
+            else if (t.text == "BITREV") st.push_back({ ByteExpr::reverse(ByteExpr::Kind::BitReverse, a.bytes), 0 });
+            else if (t.text == "POPCNT") st.push_back({ nullptr, static_cast<long long>(a.bytes->popcount()) });
+            else if (t.text == "PARITY") st.push_back({ nullptr, static_cast<long long>(a.bytes->popcount() & 1) });
+            else if (t.text == "CLZ") st.push_back({ nullptr, static_cast<long long>(a.bytes->leadingZeros()) });
+            else if (t.text == "CTZ") st.push_back({ nullptr, static_cast<long long>(a.bytes->trailingZeros()) });
+            else {
+                return failAt(err, HexErrorCode::UnsupportedOnBytes, t);
+            }
+            continue;
+        }
+
+        if (t.type == TokType::Op){
+            if (st.size() < 2) return failAt(err, HexErrorCode::NotEnoughOperands, t);
+            const Operand b = pop();
+            const Operand a = pop();
+
+            if (!a.bytes && !b.bytes){
+                // 与 wordBinary 一样在 64 位字上计算, 溢出时回绕而不是未定义行为
+                const std::uint64_t x = static_cast<std::uint64_t>(a.scalar);
+                const std::uint64_t y = static_cast<std::uint64_t>(b.scalar);
+                std::uint64_t w = 0;
+                if (t.text == "+") w = x + y;
+                else if (t.text == "-") w = x - y;
+                else if (t.text == "*") w = x * y;
+                else if (t.text == "&") w = x & y;
+                else if (t.text == "|") w = x | y;
+                else if (t.text == "^^") w = x ^ y;
+                else if (t.text == "<<" || t.text == ">>"){
+                    if (b.scalar < 0 || b.scalar > 63) return failAt(err, HexErrorCode::ShiftOutOfRange, t);
+                    w = t.text == "<<" ? x << y : static_cast<std::uint64_t>(a.scalar >> b.scalar);
+                } else if (!wordBinary(t.text, x, y, w)){
+                    return failAt(err, HexErrorCode::UnsupportedInByteExpr, t);
+                }
+                st.push_back({ nullptr, static_cast<long long>(w) });
+                continue;
+            }
+
+            if (t.text == "&" || t.text == "|" || t.text == "^^"){
+                const ByteExpr::Ptr lhs = toBytes(a);
+                const ByteExpr::Ptr rhs = toBytes(b);
+                if (!lhs || !rhs) return failAt(err, HexErrorCode::ByteOperandOutOfRange, t);
+                const ByteExpr::Kind kind = t.text == "&" ? ByteExpr::Kind::And
+                                          : t.text == "|" ? ByteExpr::Kind::Or
+                                                          : ByteExpr::Kind::Xor;
+                st.push_back({ ByteExpr::combine(kind, lhs, rhs), 0 });
+                continue;
+            }
+            if (t.text == "<<" || t.text == ">>"){
+                if (!a.bytes || b.bytes) return failAt(err, HexErrorCode::AmountNotNumber, t);
+                if (b.scalar < 0) return failAt(err, HexErrorCode::ShiftOutOfRange, t);
+                const ByteExpr::Kind kind = t.text == "<<" ? ByteExpr::Kind::Shl : ByteExpr::Kind::Shr;
+                st.push_back({ ByteExpr::shift(kind, a.bytes, b.scalar), 0 });
+                continue;
+            }
+            if (t.text == "ROL" || t.text == "ROR"){
+                if (!a.bytes || b.bytes) return failAt(err, HexErrorCode::AmountNotNumber, t);
+                const ByteExpr::Kind kind = t.text == "ROL" ? ByteExpr::Kind::Shl : ByteExpr::Kind::Shr;
+                st.push_back({ ByteExpr::rotate(kind, a.bytes, b.scalar), 0 });
+                continue;
+            }
+
+            return failAt(err, HexErrorCode::UnsupportedOnBytes, t);
+        }
+
+        if (t.type == TokType::UnaryPostOp) return failAt(err, HexErrorCode::UnsupportedInByteExpr, t);
+
+        return failAt(err, HexErrorCode::InvalidToken, t);
+    }
+
+    if (st.size() != 1) return fail(err, HexErrorCode::InvalidExpression);
+
+    out = st.back().bytes;
+    scalar = st.back().scalar;
+    return true;
+}
@@ -0,0 +1,128 @@
+#ifndef HEXENGINE_H
+#define HEXENGINE_H
+
+#include "byteexpr.h"
+#include "hexerror.h"
+#include "modarith.h"
+#include "program.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 计算引擎本体, 只依赖标准库, 可以脱离 Qt 单独嵌入
+// 表达式按 UTF-8 传入, 结果写入调用方提供的缓冲区
+// 内部复用 token / 结果缓冲, 同一个实例不要跨线程同时使用
+class HexEngine
+{
+public:
+    // 数值后端, 运行时可切换
+    enum class Backend {
+        Double,
+        LongDouble,
+        Float128,
+        Fixed64
+    };
+
+    struct Result {
+        bool isError;
+        // 完整文本的长度 (不含结尾 0), 大于等于 cap 时说明被截断
+        std::size_t length;
+        HexError error;
+    };
+
+    // 结果 (或错误信息) 按 snprintf 的方式写入 out, cap > 0 时总是以 0 结尾
+    Result compute(std::string_view expr, char *out, std::size_t cap);
+    // 同上, 写入 out 后返回是否成功
+    bool compute(std::string_view expr, std::string &out);
+    // 失败时只填 err, 不生成错误信息, out 不变
+    bool compute(std::string_view expr, std::string &out, HexError &err);
+    // 字节数组结果分块交给 sink, 适合比内存还大的输入
+    bool writeBytes(std::string_view expr, const ByteExpr::Sink &sink, std::int64_t &written, HexError &err);
+    // 编译成 64 位整数程序, 非十六进制字母开头的标识符 (X, KEY ...) 作为自由变量
+    bool compile(std::string_view expr, Program &out, HexError &err);
+
+    // 把错误码渲染成文字追加到 out, expr 为出错时传入的表达式
+    static void formatError(const HexError &err, std::string_view expr, std::string &out);
+
+    void setBackend(Backend backend) { m_backend = backend; }
+    Backend backend() const { return m_backend; }
+
+    static bool backendAvailable(Backend backend);
+    static const char *backendName(Backend backend);
+    static bool backendFromName(std::string_view name, Backend &out);
+
+    static void toHexFloatString(long double v, int fracDigits, std::string &out);
+
+private:
+    enum class TokType {
+        Number,
+        Op,
+        UnaryPreOp,
+        UnaryPostOp,
+        LParen,
+        RParen,
+        Bytes,      // #DEADBEEF 字节数组
+        File,       // "path" 内存映射文件
+        Variable    // 求解用的自由变量
+    };
+    // text 指向表达式本身或静态字符串, 只在一次调用内有效
+    // [offset, offset + length) 是 token 在表达式中的位置, 用于报错
+    struct Token {
+        TokType type;
+        std::string_view text;
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    bool parse(std::string_view expression, HexError &err);
+    bool tokenize(std::string_view expr, std::vector<Token> &outTokens, HexError &err) const;
+    bool toRpn(const std::vector<Token> &tokens, std::vector<Token> &outRpn, HexError &err);
+    template <typename B>
+    bool evalRpn(const std::vector<Token> &rpn, typename B::Value &outValue, HexError &err);
+    template <typename B>
+    bool computeWith(const std::vector<Token> &rpn, std::string &out, HexError &err);
+    // 字节数组表达式的操作数, 要么是字节数组, 要么是整数
+    struct ByteOperand {
+        ByteExpr::Ptr bytes;
+        long long scalar = 0;
+    };
+    // 结果为标量 (如 POPCNT 一个字节数组) 时 out 为空, 值写入 scalar
+    bool evalBytes(const std::vector<Token> &rpn, ByteExpr::Ptr &out, long long &scalar, HexError &err);
+    // "表达式 MOD N": 整个表达式按模 N 的整数计算, 与数值后端无关
+    bool computeModular(const std::vector<Token> &rpn, std::string &out, HexError &err);
+    static const Token *findModular(const std::vector<Token> &rpn);
+    static bool hasByteOperands(const std::vector<Token> &rpn);
+    static const Token *findVariable(const std::vector<Token> &rpn);
+    static bool parseInt64(std::string_view s, std::int64_t &out, HexErrorCode &err);
+
+    template <typename B>
+    static bool parseHexFloat(std::string_view s, typename B::Value &out, HexErrorCode &err);
+    template <typename B>
+    static void formatHex(typename B::Value v, int fracDigits, std::string &out);
+    template <typename B>
+    static typename B::Value fastPow(typename B::Value base, long long exp);
+    template <typename B>
+    static typename B::Value safePow(typename B::Value a, typename B::Value b);
+    template <typename B>
+    static typename B::Value factorial(long long n);
+
+    Backend m_backend = Backend::LongDouble;
+    std::vector<Token> m_tokens;
+    std::vector<Token> m_rpn;
+    std::string m_text;
+    // 各个求值函数的栈, 重复求值时复用容量, 不再分配
+    std::vector<Token> m_opStack;
+    // evalRpn 的值栈, 元素类型随数值后端变化 (double / __float128 / Fixed64 ...), 按原始存储保存
+    std::vector<std::max_align_t> m_valueStack;
+    std::vector<ByteOperand> m_byteStack;
+    std::vector<std::uint64_t> m_modStack;
+    std::vector<const Token *> m_modLiteral;
+    std::vector<std::uint64_t> m_exponent;
+    // 模数不变时复用 Montgomery / Barrett 的预计算
+    ModContext m_mod;
+    std::string m_modulus;
+};
+
+#endif // HEXENGINE_H
@@ -0,0 +1,70 @@
+#ifndef HEXERROR_H
+#define HEXERROR_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 解析 / 求值的错误码, 数值会出现在 C 接口里, 只增不改
+enum class HexErrorCode : std::uint8_t {
+    None = 0,
+    EmptyExpression = 1,
+    UnexpectedChar = 2,
+    InvalidOperator = 3,            // 单独的 < 或 >
+    InvalidNumber = 4,              // 单独的 '.'
+    EmptyByteLiteral = 5,
+    UnterminatedFileName = 6,
+    MismatchedParentheses = 7,
+    NotEnoughOperands = 8,
+    NotEnoughOperandsUnary = 9,
+    InvalidExpression = 10,
+    UnknownOperator = 11,
+    UnknownVariable = 12,
+    InvalidIntegerDigit = 13,
+    InvalidFractionDigit = 14,
+    InvalidHexFloat = 15,
+    InvalidByteLiteral = 16,
+    DivisionByZero = 17,
+    ModuloByZero = 18,
+    ZeroToNegativePower = 19,
+    NegativeBaseNonInteger = 20,
+    IntegerRequired = 21,           // 位操作 / 阶乘的操作数不是整数
+    ShiftOutOfRange = 22,
+    FactorialOfNegative = 23,
+    FactorialOverflow = 24,
+    MathOverflow = 25,              // 结果为无穷大
+    ByteIntegerRequired = 26,
+    ByteOperandOutOfRange = 27,
+    AmountNotNumber = 28,           // 字节数组的移位数是字节数组
+    UnsupportedInByteExpr = 29,
+    UnsupportedOnBytes = 30,
+    NotByteResult = 31,
+    FileOpenFailed = 32,
+    FileMapFailed = 33,
+    WriteFailed = 34,
+    BytesNotSolvable = 35,          // 保留编号, 已由 NotCompilable 代替
+    ConstantNotInteger = 36,        // 同上
+    ConstantTooLarge = 37,
+    InvalidToken = 38,
+    InvalidModulus = 39,            // MOD 的模数不是 >= 2 的整数
+    ModulusNotConstant = 40,        // MOD 不在最外层, 或模数不是常数
+    ModulusRequired = 41,           // INV 只能在 MOD 表达式中使用
+    UnsupportedInModMode = 42,
+    NotInvertible = 43,
+    ExponentNotConstant = 44,       // 模幂的指数必须是常数
+    ModOperandNotInteger = 45,
+    InvalidLibrary = 46,            // 程序库文件头 / 段不合法, 或字节序不同
+    UnsupportedLibraryVersion = 47,
+    DuplicateProgramName = 48,
+    NotCompilable = 49,             // 小数 / 字节数组 / MOD 无法编译成 64 位整数程序
+    OutOfMemory = 50
+};
+
+// 错误码加上出错 token 在表达式中的字节区间, 不分配内存
+// 文字信息只在需要显示时才由 HexEngine::formatError() 生成
+struct HexError {
+    HexErrorCode code = HexErrorCode::None;
+    std::size_t offset = 0;
+    std::size_t length = 0;     // 0 表示没有具体位置
+};
+
+#endif // HEXERROR_H
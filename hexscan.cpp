@@ -0,0 +1,190 @@
+#include "hexscan.h"
+#include "cpufeatures.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HEXSCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HEXSCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HEXSCAN_TARGET_AVX2
+#endif
+
+namespace {
+
+int hexNibble(char c){
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+    return -1;
+}
+
+std::size_t runLengthScalar(const char *p, std::size_t n){
+    std::size_t i = 0;
+    while (i < n && hexNibble(p[i]) >= 0) i++;
+    return i;
+}
+
+std::size_t toWordsScalar(const char *p, std::size_t n, std::uint64_t *out){
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 16 <= n; i += 16){
+        if (!hexToWord(p + i, 16, out[count])) break;
+        count++;
+    }
+    return count;
+}
+
+#ifdef HEXSCAN_X86
+
+unsigned trailingZeros(unsigned v){
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return idx;
+#else
+    return static_cast<unsigned>(__builtin_ctz(v));
+#endif
+}
+
+std::uint64_t byteSwap(std::uint64_t v){
+#if defined(_MSC_VER)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+// 0-9 / A-F 对应字节置 0xFF; 非 ASCII 字节按有符号比较为负数, 自然落在范围外
+__m128i hexMask128(__m128i v){
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                         _mm_cmplt_epi8(v, _mm_set1_epi8('F' + 1)));
+    return _mm_or_si128(digit, letter);
+}
+
+// 已校验的 16 个字符 -> 8 字节: nibble = (c & 0xF) + (c > '9' ? 9 : 0), 相邻两个 nibble 合并
+__m128i packNibbles128(__m128i v){
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('9')), _mm_set1_epi8(9));
+    const __m128i nib = _mm_add_epi8(_mm_and_si128(v, _mm_set1_epi8(0x0F)), letter);
+    const __m128i hi = _mm_slli_epi16(_mm_and_si128(nib, _mm_set1_epi16(0x00FF)), 4);
+    const __m128i lo = _mm_srli_epi16(nib, 8);
+    return _mm_packus_epi16(_mm_or_si128(hi, lo), _mm_setzero_si128());
+}
+
+std::size_t runLengthSse2(const char *p, std::size_t n){
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hexMask128(v)));
+        if (mask != 0xFFFFu) return i + trailingZeros(~mask);
+    }
+    return i + runLengthScalar(p + i, n - i);
+}
+
+std::size_t toWordsSse2(const char *p, std::size_t n, std::uint64_t *out){
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 16 <= n; i += 16){
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        if (_mm_movemask_epi8(hexMask128(v)) != 0xFFFF) break;
+        const std::uint64_t bytes = static_cast<std::uint64_t>(_mm_cvtsi128_si64(packNibbles128(v)));
+        out[count++] = byteSwap(bytes);
+    }
+    return count;
+}
+
+HEXSCAN_TARGET_AVX2 __m256i hexMask256(__m256i v){
+    const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    const __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('F' + 1), v));
+    return _mm256_or_si256(digit, letter);
+}
+
+HEXSCAN_TARGET_AVX2 std::size_t runLengthAvx2(const char *p, std::size_t n){
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hexMask256(v)));
+        if (mask != 0xFFFFFFFFu) return i + trailingZeros(~mask);
+    }
+    return i + runLengthSse2(p + i, n - i);
+}
+
+HEXSCAN_TARGET_AVX2 std::size_t toWordsAvx2(const char *p, std::size_t n, std::uint64_t *out){
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        if (static_cast<unsigned>(_mm256_movemask_epi8(hexMask256(v))) != 0xFFFFFFFFu) break;
+
+        const __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('9')), _mm256_set1_epi8(9));
+        const __m256i nib = _mm256_add_epi8(_mm256_and_si256(v, _mm256_set1_epi8(0x0F)), letter);
+        const __m256i hi = _mm256_slli_epi16(_mm256_and_si256(nib, _mm256_set1_epi16(0x00FF)), 4);
+        const __m256i lo = _mm256_srli_epi16(nib, 8);
+        // packus 按 128 位通道打包, 两个字分别位于第 0 和第 2 个 64 位槽
+        const __m256i packed = _mm256_packus_epi16(_mm256_or_si256(hi, lo), _mm256_setzero_si256());
+        out[count++] = byteSwap(static_cast<std::uint64_t>(_mm256_extract_epi64(packed, 0)));
+        out[count++] = byteSwap(static_cast<std::uint64_t>(_mm256_extract_epi64(packed, 2)));
+    }
+    return count + toWordsSse2(p + i, n - i, out + count);
+}
+
+#endif // HEXSCAN_X86
+
+struct Kernels {
+    std::size_t (*runLength)(const char *, std::size_t);
+    std::size_t (*toWords)(const char *, std::size_t, std::uint64_t *);
+    const char *name;
+};
+
+Kernels selectKernels(){
+#ifdef HEXSCAN_X86
+    if (cpuHasAvx2()) return { runLengthAvx2, toWordsAvx2, "avx2" };
+    return { runLengthSse2, toWordsSse2, "sse2" };
+#else
+    return { runLengthScalar, toWordsScalar, "scalar" };
+#endif
+}
+
+const Kernels &kernels(){
+    static const Kernels k = selectKernels();
+    return k;
+}
+
+} // namespace
+
+std::size_t hexRunLength(const char *p, std::size_t n){
+    return kernels().runLength(p, n);
+}
+
+std::size_t hexToWords(const char *p, std::size_t n, std::uint64_t *out){
+    return kernels().toWords(p, n, out);
+}
+
+bool hexToWord(const char *p, std::size_t n, std::uint64_t &out){
+    std::uint64_t w = 0;
+    for (std::size_t i = 0; i < n; i++){
+        const int d = hexNibble(p[i]);
+        if (d < 0) return false;
+        w = (w << 4) | static_cast<std::uint64_t>(d);
+    }
+    out = w;
+    return true;
+}
+
+const char *hexScanImplementation(){
+    return kernels().name;
+}
+
+std::size_t hexRunLengthScalar(const char *p, std::size_t n){
+    return runLengthScalar(p, n);
+}
+
+std::size_t hexToWordsScalar(const char *p, std::size_t n, std::uint64_t *out){
+    return toWordsScalar(p, n, out);
+}
@@ -0,0 +1,28 @@
+#ifndef HEXSCAN_H
+#define HEXSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 十六进制数字的批量校验 / 转换
+// 运行时按 CPU 选择 AVX2 (每次 32 字符) / SSE2 (每次 16 字符) / 标量实现
+// 只接受大写 0-9 A-F, 与 tokenize() 一致
+
+// p 开头连续十六进制数字的个数
+std::size_t hexRunLength(const char *p, std::size_t n);
+
+// 每 16 个字符转换为一个 64 位字, 高位在前; n 必须是 16 的倍数
+// 返回成功转换的字数, 遇到非法字符提前停止
+std::size_t hexToWords(const char *p, std::size_t n, std::uint64_t *out);
+
+// 不超过 16 个字符的标量转换, 含非法字符时返回 false
+bool hexToWord(const char *p, std::size_t n, std::uint64_t &out);
+
+// 当前使用的实现: "avx2" / "sse2" / "scalar"
+const char *hexScanImplementation();
+
+// 标量实现, 与上面的结果相同, 供 hexcalc_bench 对比
+std::size_t hexRunLengthScalar(const char *p, std::size_t n);
+std::size_t hexToWordsScalar(const char *p, std::size_t n, std::uint64_t *out);
+
+#endif // HEXSCAN_H
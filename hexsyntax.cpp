@@ -0,0 +1,49 @@
+#include "hexsyntax.h"
+
+namespace {
+
+struct Keyword {
+    std::string_view name;
+    KeywordKind kind;
+};
+constexpr Keyword kKeywords[] = {
+    { "POPCNT", KeywordKind::Unary }, { "CLZ", KeywordKind::Unary }, { "CTZ", KeywordKind::Unary },
+    { "PARITY", KeywordKind::Unary }, { "BSWAP", KeywordKind::Unary }, { "BITREV", KeywordKind::Unary },
+    { "ROL", KeywordKind::Binary }, { "ROR", KeywordKind::Binary },
+    { "PEXT", KeywordKind::Binary }, { "PDEP", KeywordKind::Binary },
+    { "INV", KeywordKind::Unary }, { "MOD", KeywordKind::Binary }
+};
+
+} // namespace
+
+std::string_view findKeyword(std::string_view word, KeywordKind &kind){
+    for (const Keyword &k : kKeywords){
+        if (k.name == word){
+            kind = k.kind;
+            return k.name;
+        }
+    }
+    kind = KeywordKind::None;
+    return std::string_view();
+}
+
+int operatorPrecedence(std::string_view op){
+    if (op == "!" || op == "~") return 6;
+    if (op == "POPCNT" || op == "CLZ" || op == "CTZ" || op == "PARITY" || op == "BSWAP" || op == "BITREV" || op == "INV") return 6;
+    if (op == "^") return 5;
+    if (op == "*" || op == "/" || op == "%") return 4;
+    if (op == "+" || op == "-") return 3;
+    if (op == "<<" || op == ">>" || op == "ROL" || op == "ROR") return 2;
+    if (op == "&" || op == "PEXT" || op == "PDEP") return 1;
+    if (op == "^^") return 0;
+    if (op == "|") return -1;
+    if (op == "MOD") return -2;     // 只能出现在最外层, 整个表达式按模 N 计算
+    return -10;
+}
+
+bool isLeftAssociative(std::string_view op){
+    if (op == "^") return false;
+    if (op == "~") return false;
+    if (op == "POPCNT" || op == "CLZ" || op == "CTZ" || op == "PARITY" || op == "BSWAP" || op == "BITREV" || op == "INV") return false;
+    return true;
+}
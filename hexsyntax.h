@@ -0,0 +1,35 @@
+#ifndef HEXSYNTAX_H
+#define HEXSYNTAX_H
+
+#include <string_view>
+
+// 词法 / 运算符规则, HexEngine::tokenize() 和 StreamParser 共用, 保证两者结果一致
+
+enum class KeywordKind {
+    None,
+    Unary,      // POPCNT / CLZ / INV ... 前缀运算符
+    Binary      // ROL / ROR / PEXT / PDEP / MOD
+};
+
+// 位操作 / 模运算关键字, 必须与整个标识符完全相同才识别
+// 返回静态存储的关键字名字, 不是关键字时返回空并把 kind 置为 None
+std::string_view findKeyword(std::string_view word, KeywordKind &kind);
+
+int operatorPrecedence(std::string_view op);
+bool isLeftAssociative(std::string_view op);
+
+inline bool isExprSpace(char c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// 只接受大写, 与 hexRunLength() 一致
+inline bool isHexDigit(char c){
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F');
+}
+
+// 标识符 / 关键字中允许的字符
+inline bool isWordChar(char c){
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+#endif // HEXSYNTAX_H
@@ -0,0 +1,87 @@
+#include "latencytracer.h"
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+
+int bucketFor(qint64 nsecs){
+    qint64 us = nsecs / 1000;
+    int idx = 0;
+    while (us > 0 && idx < LatencyTracer::kBucketCount - 1){
+        us >>= 1;
+        idx++;
+    }
+    return idx;
+}
+
+QString bucketLabel(int idx){
+    if (idx == 0) return "<1us";
+    if (idx == LatencyTracer::kBucketCount - 1) return QString(">=%1us").arg(1ll << (idx - 1));
+    return QString("<%1us").arg(1ll << idx);
+}
+
+} // namespace
+
+void LatencyTracer::record(Stage stage, qint64 nsecs){
+    Histogram &h = m_hist[static_cast<int>(stage)];
+    h.count++;
+    h.totalNs += nsecs;
+    h.maxNs = std::max(h.maxNs, nsecs);
+    h.buckets[bucketFor(nsecs)]++;
+}
+
+void LatencyTracer::reset(){
+    for (Histogram &h : m_hist) h = Histogram();
+}
+
+QString LatencyTracer::stageName(Stage stage){
+    switch (stage){
+    case Stage::Filter: return "filter";
+    case Stage::Normalize: return "normalize";
+    case Stage::Compute: return "compute";
+    case Stage::Repaint: return "repaint";
+    }
+    return QString();
+}
+
+qint64 LatencyTracer::percentileUpperUs(const Histogram &h, double p){
+    const quint64 target = static_cast<quint64>(p * static_cast<double>(h.count));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; i++){
+        seen += h.buckets[i];
+        if (seen > target) return 1ll << i;
+    }
+    return 1ll << (kBucketCount - 1);
+}
+
+QString LatencyTracer::report() const{
+    QStringList lines;
+    for (int s = 0; s < kStageCount; s++){
+        const Histogram &h = m_hist[s];
+        const QString name = stageName(static_cast<Stage>(s));
+        if (h.count == 0){
+            lines << QString("%1: no samples").arg(name, -10);
+            continue;
+        }
+
+        const double meanUs = static_cast<double>(h.totalNs) / static_cast<double>(h.count) / 1000.0;
+        lines << QString("%1: n=%2  mean=%3us  p50<%4us  p99<%5us  max=%6us")
+                     .arg(name, -10)
+                     .arg(h.count)
+                     .arg(meanUs, 0, 'f', 1)
+                     .arg(percentileUpperUs(h, 0.50))
+                     .arg(percentileUpperUs(h, 0.99))
+                     .arg(static_cast<double>(h.maxNs) / 1000.0, 0, 'f', 1);
+
+        const quint64 peak = *std::max_element(std::begin(h.buckets), std::end(h.buckets));
+        for (int i = 0; i < kBucketCount; i++){
+            if (h.buckets[i] == 0) continue;
+            const int width = static_cast<int>(40 * h.buckets[i] / peak);
+            lines << QString("  %1 |%2 %3")
+                         .arg(bucketLabel(i), 10)
+                         .arg(QString(std::max(width, 1), '#'))
+                         .arg(h.buckets[i]);
+        }
+    }
+    return lines.join('\n');
+}
@@ -0,0 +1,55 @@
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+// 界面响应耗时统计, 每个阶段一个按 2 的幂分桶的直方图
+class LatencyTracer
+{
+public:
+    enum class Stage {
+        Filter,     // 输入过滤 / << >> 自动补全
+        Normalize,  // normalizeExpression()
+        Compute,    // CalculatorCore::compute()
+        Repaint     // 同步重绘输入 / 结果框
+    };
+    static constexpr int kStageCount = 4;
+    // 桶 0: < 1us, 桶 i: [2^(i-1), 2^i) us, 最后一个桶收纳更慢的
+    static constexpr int kBucketCount = 24;
+
+    // 作用域计时, 析构时记录
+    class Scope
+    {
+    public:
+        Scope(LatencyTracer &tracer, Stage stage)
+            : m_tracer(tracer), m_stage(stage) { m_timer.start(); }
+        ~Scope() { m_tracer.record(m_stage, m_timer.nsecsElapsed()); }
+
+    private:
+        LatencyTracer &m_tracer;
+        Stage m_stage;
+        QElapsedTimer m_timer;
+    };
+
+    void record(Stage stage, qint64 nsecs);
+    void reset();
+    QString report() const;
+
+    static QString stageName(Stage stage);
+
+private:
+    struct Histogram {
+        quint64 count = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        quint64 buckets[kBucketCount] = {};
+    };
+
+    // 直方图近似的百分位, 返回所在桶的上界 (us)
+    static qint64 percentileUpperUs(const Histogram &h, double p);
+
+    Histogram m_hist[kStageCount];
+};
+
+#endif // LATENCYTRACER_H
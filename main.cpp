@@ -1,13 +1,290 @@
 #include "mainwindow.h"
+#include "hexengine.h"
+#include "solver.h"
+#include "programlib.h"
 
 #include <QApplication>
-#include <QStyleFactory> 
-#include <QPalette>  
+#include <QCommandLineParser>
+#include <QFile>
+#include <QStyleFactory>
+#include <QPalette>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+// 带表达式参数 (或 --help) 时以命令行模式运行, 不创建窗口
+static bool isCliInvocation(int argc, char *argv[]){
+    static const char *const valueOptions[] = { "-b", "--backend", "-o", "--output", "--replay", "--repeat",
+                                                "--target", "--range", "--limit", "--build-lib" };
+    for (int i = 1; i < argc; i++){
+        const char *arg = argv[i];
+        if (!std::strcmp(arg, "--solve") || !std::strcmp(arg, "--build-lib") || !std::strcmp(arg, "--list-lib")) return true;
+        bool takesValue = false;
+        for (const char *opt : valueOptions){
+            if (!std::strcmp(arg, opt)) takesValue = true;
+        }
+        if (takesValue){
+            i++;
+            continue;
+        }
+        if (!std::strcmp(arg, "-h") || !std::strcmp(arg, "--help") || !std::strcmp(arg, "-?")) return true;
+        if (arg[0] != '-') return true;
+    }
+    return false;
+}
+
+// 引号内是文件路径, 保持原样
+static QString upperOutsideQuotes(const QString &expr){
+    QString out = expr;
+    bool quoted = false;
+    for (int i = 0; i < out.size(); i++){
+        if (out[i] == '"') quoted = !quoted;
+        else if (!quoted) out[i] = out[i].toUpper();
+    }
+    return out;
+}
+
+static int runCli(const QStringList &expressions, CalculatorCore::Backend backend, const QString &outputPath){
+    CalculatorCore calc;
+    calc.setBackend(backend);
+
+    if (!outputPath.isEmpty()){
+        if (expressions.size() != 1){
+            std::fputs("--output takes exactly one expression\n", stderr);
+            return 1;
+        }
+        const CalculatorCore::Result res = calc.computeToFile(upperOutsideQuotes(expressions.first()), outputPath);
+        std::fputs(qPrintable(res.valueStr + '\n'), res.isError ? stderr : stdout);
+        return res.isError ? 1 : 0;
+    }
+
+    int failures = 0;
+    for (const QString &expr : expressions){
+        const CalculatorCore::Result res = calc.compute(upperOutsideQuotes(expr));
+        std::fputs(qPrintable(res.valueStr + '\n'), res.isError ? stderr : stdout);
+        if (res.isError) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+static QString hexSigned(std::int64_t v){
+    return v < 0 ? "-" + QString::number(0 - static_cast<quint64>(v), 16).toUpper()
+                 : QString::number(static_cast<quint64>(v), 16).toUpper();
+}
+
+static int runSolve(const QString &expr, const QString &target, const QStringList &ranges, const QString &limit){
+    std::string err;
+    Program program;
+    HexEngine engine;
+    const std::string source = upperOutsideQuotes(expr).toStdString();
+    HexError compileErr;
+    if (!engine.compile(source, program, compileErr)){
+        HexEngine::formatError(compileErr, source, err);
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+
+    Solver::Options options;
+    if (!Solver::parseTarget(target.toStdString(), options.compare, options.target, err)){
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+    bool ok = true;
+    options.limit = limit.isEmpty() ? 0 : limit.toULongLong(&ok);
+    if (!ok){
+        std::fputs("--limit expects a number\n", stderr);
+        return 1;
+    }
+
+    // 没有指定范围的变量默认搜索 32 位
+    options.ranges.assign(program.vars.size(), Solver::Range{ 0, 0xFFFFFFFFll });
+    for (const QString &spec : ranges){
+        std::string name;
+        Solver::Range range;
+        if (!Solver::parseRange(spec.toStdString(), name, range, err)){
+            std::fprintf(stderr, "%s\n", err.c_str());
+            return 1;
+        }
+        const auto it = std::find(program.vars.begin(), program.vars.end(), name);
+        if (it == program.vars.end()){
+            std::fprintf(stderr, "unknown variable '%s'\n", name.c_str());
+            return 1;
+        }
+        options.ranges[static_cast<std::size_t>(it - program.vars.begin())] = range;
+    }
+
+    options.progress = [](std::uint64_t scanned, std::uint64_t total, std::uint64_t found){
+        std::fprintf(stderr, "\r%5.1f%%  %llu found", 100.0 * static_cast<double>(scanned) / static_cast<double>(total),
+                     static_cast<unsigned long long>(found));
+        return true;
+    };
+
+    std::vector<std::int64_t> solutions;
+    const bool solved = Solver::solve(program, options, solutions, err);
+    std::fputs("\n", stderr);
+    if (!solved){
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+
+    const std::size_t varCount = program.vars.size();
+    for (std::size_t i = 0; i < solutions.size(); i += varCount){
+        QStringList parts;
+        for (std::size_t v = 0; v < varCount; v++){
+            parts << QString::fromStdString(program.vars[v]) + "=" + hexSigned(solutions[i + v]);
+        }
+        std::puts(qPrintable(parts.join(' ')));
+    }
+    return solutions.empty() ? 1 : 0;
+}
+
+// 文件路径放在表达式位置, 让 "cannot open '...'" 之类的信息带上路径
+static void printFileError(HexErrorCode code, const std::string &path){
+    std::string msg;
+    HexEngine::formatError(HexError{ code, 0, path.size() }, path, msg);
+    std::fprintf(stderr, "%s\n", msg.c_str());
+}
+
+// 源文件每行一个 NAME = EXPR, 空行和 // 开头的行忽略
+static int runBuildLib(const QString &outputPath, const QStringList &sources){
+    std::vector<std::pair<std::string, Program>> programs;
+    HexEngine engine;
+    int failures = 0;
+    for (const QString &path : sources){
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)){
+            printFileError(HexErrorCode::FileOpenFailed, path.toStdString());
+            return 1;
+        }
+        int lineNo = 0;
+        while (!file.atEnd()){
+            lineNo++;
+            const QString line = QString::fromUtf8(file.readLine()).trimmed();
+            if (line.isEmpty() || line.startsWith("//")) continue;
+
+            const int eq = line.indexOf('=');
+            const QString name = eq < 0 ? QString() : line.left(eq).trimmed();
+            if (name.isEmpty()){
+                std::fprintf(stderr, "%s:%d: expected NAME = EXPR\n", qPrintable(path), lineNo);
+                failures++;
+                continue;
+            }
+            const std::string source = upperOutsideQuotes(line.mid(eq + 1).trimmed()).toStdString();
+            Program program;
+            HexError err;
+            if (!engine.compile(source, program, err)){
+                std::string msg;
+                HexEngine::formatError(err, source, msg);
+                std::fprintf(stderr, "%s:%d: %s\n", qPrintable(path), lineNo, msg.c_str());
+                failures++;
+                continue;
+            }
+            programs.emplace_back(name.toStdString(), std::move(program));
+        }
+    }
+    if (failures) return 1;
+
+    HexErrorCode err = HexErrorCode::None;
+    if (!ProgramLibrary::write(outputPath.toStdString(), programs, err)){
+        printFileError(err, outputPath.toStdString());
+        return 1;
+    }
+    std::fprintf(stderr, "%zu programs written\n", programs.size());
+    return 0;
+}
+
+static int runListLib(const QString &path){
+    ProgramLibrary lib;
+    HexErrorCode err = HexErrorCode::None;
+    if (!lib.open(path.toStdString(), err)){
+        printFileError(err, path.toStdString());
+        return 1;
+    }
+    int failures = 0;
+    for (std::size_t i = 0; i < lib.size(); i++){
+        ProgramView view;
+        const std::string_view name = lib.name(i);
+        if (!lib.at(i, view) || !view.verify()){
+            std::fprintf(stderr, "%.*s: invalid program\n", static_cast<int>(name.size()), name.data());
+            failures++;
+            continue;
+        }
+        std::string vars;
+        for (std::size_t v = 0; v < view.varCount; v++){
+            if (v) vars += ' ';
+            vars += lib.varName(i, v);
+        }
+        std::printf("%.*s\t[%s]\t%zu insns, depth %u\n", static_cast<int>(name.size()), name.data(), vars.c_str(),
+                    view.codeSize, static_cast<unsigned>(view.maxDepth));
+    }
+    return failures == 0 ? 0 : 1;
+}
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
-    a.setStyle(QStyleFactory::create("Fusion"));
+    const bool cli = isCliInvocation(argc, argv);
+    std::unique_ptr<QCoreApplication> app(cli ? new QCoreApplication(argc, argv)
+                                              : new QApplication(argc, argv));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("HexCalculator");
+    parser.addHelpOption();
+    QCommandLineOption backendOption({"b", "backend"},
+                                     "Numeric backend: " + CalculatorCore::backendNames().join(", ") + ".",
+                                     "name",
+                                     CalculatorCore::backendName(CalculatorCore::Backend::LongDouble));
+    parser.addOption(backendOption);
+    QCommandLineOption outputOption({"o", "output"},
+                                    "Stream a byte array result into a file.",
+                                    "file");
+    parser.addOption(outputOption);
+    QCommandLineOption replayOption("replay",
+                                    "Replay a recorded keystroke session and print the latency report.",
+                                    "session");
+    parser.addOption(replayOption);
+    QCommandLineOption repeatOption("repeat", "Replay the session n times.", "n", "1");
+    parser.addOption(repeatOption);
+    QCommandLineOption solveOption("solve",
+                                   "Search for values of the free variables (e.g. X) that make the expression hit --target.",
+                                   "expression");
+    parser.addOption(solveOption);
+    QCommandLineOption targetOption("target", "Target value, optionally prefixed by = != < <= > >=.", "value", "0");
+    parser.addOption(targetOption);
+    QCommandLineOption rangeOption("range", "Search range of a variable, NAME=LO..HI (default 0..FFFFFFFF).", "range");
+    parser.addOption(rangeOption);
+    QCommandLineOption limitOption("limit", "Stop after the first n solutions.", "n");
+    parser.addOption(limitOption);
+    QCommandLineOption buildLibOption("build-lib",
+                                      "Compile the NAME = EXPR lines of the given files into a program library.",
+                                      "file");
+    parser.addOption(buildLibOption);
+    QCommandLineOption listLibOption("list-lib", "List the programs in a program library.", "file");
+    parser.addOption(listLibOption);
+    parser.addPositionalArgument("expression", "Evaluate and print instead of opening the window.", "[expression...]");
+    parser.process(*app);
+
+    CalculatorCore::Backend backend;
+    if (!CalculatorCore::backendFromName(parser.value(backendOption), backend)){
+        std::fprintf(stderr, "unknown backend '%s'\n", qPrintable(parser.value(backendOption)));
+        return 1;
+    }
+
+    if (parser.isSet(solveOption)){
+        return runSolve(parser.value(solveOption), parser.value(targetOption),
+                        parser.values(rangeOption), parser.value(limitOption));
+    }
+    if (parser.isSet(buildLibOption)){
+        return runBuildLib(parser.value(buildLibOption), parser.positionalArguments());
+    }
+    if (parser.isSet(listLibOption)){
+        return runListLib(parser.value(listLibOption));
+    }
+    if (cli){
+        return runCli(parser.positionalArguments(), backend, parser.value(outputOption));
+    }
+
+    QApplication::setStyle(QStyleFactory::create("Fusion"));
 
     QPalette darkPalette;
     darkPalette.setColor(QPalette::Window, QColor(53, 53, 53));
@@ -23,10 +300,28 @@ int main(int argc, char *argv[])
     darkPalette.setColor(QPalette::Link, QColor(42, 130, 218));
     darkPalette.setColor(QPalette::Highlight, QColor(42, 130, 218));
     darkPalette.setColor(QPalette::HighlightedText, Qt::black);
-    
-    a.setPalette(darkPalette);
+
+    QApplication::setPalette(darkPalette);
 
     MainWindow w;
+    w.setBackend(backend);
     w.show();
-    return a.exec();
+
+    // 离屏重放: QT_QPA_PLATFORM=offscreen HexCalculator --replay x.session
+    if (parser.isSet(replayOption)){
+        bool ok = false;
+        const int repeat = parser.value(repeatOption).toInt(&ok);
+        if (!ok || repeat < 1){
+            std::fputs("--repeat expects a positive integer\n", stderr);
+            return 1;
+        }
+        QString err;
+        if (!w.replaySession(parser.value(replayOption), repeat, err)){
+            std::fprintf(stderr, "%s\n", qPrintable(err));
+            return 1;
+        }
+        std::fputs(qPrintable(w.tracer().report() + '\n'), stdout);
+        return 0;
+    }
+    return app->exec();
 }
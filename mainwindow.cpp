@@ -1,6 +1,16 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include <QPushButton>
+#include <QComboBox>
+#include <QStatusBar>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QPlainTextEdit>
+#include <QVBoxLayout>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QFontDatabase>
+#include <QElapsedTimer>
 #include <QRegularExpression>
 
 MainWindow::MainWindow(QWidget *parent)
@@ -9,6 +19,8 @@ MainWindow::MainWindow(QWidget *parent)
 {
     ui->setupUi(this);
     //init
+    setupBackendSelector();
+    setupTracingControls();
     setupConnections();
 }
 
@@ -17,11 +29,130 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+void MainWindow::setupBackendSelector(){
+    m_backendBox = new QComboBox(this);
+    m_backendBox->setFocusPolicy(Qt::NoFocus);
+    m_backendBox->addItems(CalculatorCore::backendNames());
+    m_backendBox->setCurrentText(CalculatorCore::backendName(m_calc.backend()));
+    ui->statusbar->addPermanentWidget(m_backendBox);
+}
+
+void MainWindow::setupTracingControls(){
+    auto *recordButton = new QPushButton("REC", this);
+    recordButton->setCheckable(true);
+    recordButton->setFocusPolicy(Qt::NoFocus);
+    recordButton->setToolTip("Record a keystroke session for replay");
+    connect(recordButton,&QPushButton::toggled,this,&MainWindow::onRecordToggled);
+    ui->statusbar->addPermanentWidget(recordButton);
+
+    auto *latencyButton = new QPushButton("Latency", this);
+    latencyButton->setFocusPolicy(Qt::NoFocus);
+    connect(latencyButton,&QPushButton::clicked,this,&MainWindow::showLatencyReport);
+    ui->statusbar->addPermanentWidget(latencyButton);
+}
+
+void MainWindow::onRecordToggled(bool checked){
+    if (!checked){
+        m_session.stop();
+        return;
+    }
+
+    const QString path = QFileDialog::getSaveFileName(this, "Record session", QString(), "Session (*.session)");
+    QString err;
+    if (path.isEmpty() || !m_session.start(path, err)){
+        if (!err.isEmpty()) QMessageBox::warning(this, "Record session", err);
+        auto *button = qobject_cast<QPushButton*>(sender());
+        if (button){
+            const QSignalBlocker blocker(button);
+            button->setChecked(false);
+        }
+    }
+}
+
+void MainWindow::showLatencyReport(){
+    QDialog dialog(this);
+    dialog.setWindowTitle("Latency");
+    dialog.resize(640, 480);
+
+    auto *view = new QPlainTextEdit(&dialog);
+    view->setReadOnly(true);
+    view->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    view->setPlainText(m_tracer.report());
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Reset | QDialogButtonBox::Close, &dialog);
+    connect(buttons->button(QDialogButtonBox::Reset),&QPushButton::clicked,&dialog,[this, view](){
+        m_tracer.reset();
+        view->setPlainText(m_tracer.report());
+    });
+    connect(buttons,&QDialogButtonBox::rejected,&dialog,&QDialog::reject);
+
+    auto *layout = new QVBoxLayout(&dialog);
+    layout->addWidget(view);
+    layout->addWidget(buttons);
+    dialog.exec();
+}
+
+bool MainWindow::replaySession(const QString &path, int repeat, QString &err){
+    QVector<SessionLog::Event> events;
+    if (!SessionLog::load(path, events, err)) return false;
+
+    for (int r = 0; r < repeat; r++){
+        clearAll();
+        m_lastText.clear();
+        for (const SessionLog::Event &e : events){
+            switch (e.type){
+            case SessionLog::Event::Type::Edit:
+                // textEdited 只由用户输入触发, 这里先还原输入框状态再直接调用槽
+                ui->exprLineEdit->setText(e.text);
+                ui->exprLineEdit->setCursorPosition(e.cursor);
+                onExprTextEdited(e.text);
+                break;
+            case SessionLog::Event::Type::Click: {
+                auto *b = ui->buttonWidget->findChild<QPushButton*>(e.text);
+                if (!b){
+                    err = QString("unknown button '%1'").arg(e.text);
+                    return false;
+                }
+                b->click();
+                break;
+            }
+            case SessionLog::Event::Type::Return:
+                onExprReturnPressed();
+                break;
+            }
+            QCoreApplication::processEvents();
+        }
+    }
+    return true;
+}
+
+void MainWindow::repaintTraced(QWidget *w){
+    if (!w->isVisible()) return;
+    LatencyTracer::Scope scope(m_tracer, LatencyTracer::Stage::Repaint);
+    w->repaint();
+}
+
+void MainWindow::setBackend(CalculatorCore::Backend backend){
+    m_backendBox->setCurrentText(CalculatorCore::backendName(backend));
+}
+
+void MainWindow::onBackendChanged(const QString &name){
+    CalculatorCore::Backend backend;
+    if (!CalculatorCore::backendFromName(name, backend)) return;
+    m_calc.setBackend(backend);
+
+    if (!ui->resultLineEdit->text().isEmpty()){
+        computeAndShow();
+    }
+}
+
 void MainWindow::setupConnections(){
     connect(ui->exprLineEdit,&QLineEdit::returnPressed,
             this,&MainWindow::onExprReturnPressed);
     connect(ui->exprLineEdit,&QLineEdit::textEdited,
             this,&MainWindow::onExprTextEdited);
+    connect(m_backendBox,&QComboBox::currentTextChanged,
+            this,&MainWindow::onBackendChanged);
     const auto buttons = ui->buttonWidget->findChildren<QPushButton*>();
     for (QPushButton *b : buttons){
         b->setFocusPolicy(Qt::NoFocus);
@@ -30,12 +161,18 @@ void MainWindow::setupConnections(){
 }
 
 void MainWindow::onExprReturnPressed(){
+    m_session.recordReturn();
     computeAndShow();
 }
 void MainWindow::onExprTextEdited(const QString &text){
     if (m_updatingText) return;
 
-    static const QString allowedChars = "0123456789ABCDEFabcdef.+-*/%^!&|~<>()=xX÷！（）《》～";
+    m_session.recordEdit(text, ui->exprLineEdit->cursorPosition());
+    QElapsedTimer filterTimer;
+    filterTimer.start();
+
+    static const QString allowedChars = "0123456789ABCDEFabcdef.+-*/%^!&|~<>()=xX÷！（）《》～#"
+                                          "ILMNOPRSTVWYZilmnoprstvwyz";
 
     QString filteredText;
     for (const QChar &c : text){
@@ -47,6 +184,7 @@ void MainWindow::onExprTextEdited(const QString &text){
     if (text.contains('=')){
         QString exprWithoutEqual = filteredText;
         exprWithoutEqual.remove('=');
+        m_tracer.record(LatencyTracer::Stage::Filter, filterTimer.nsecsElapsed());
 
         m_updatingText = true;
         ui->exprLineEdit->setText(normalizeExpression(exprWithoutEqual));
@@ -74,8 +212,7 @@ void MainWindow::onExprTextEdited(const QString &text){
     newText.replace("》", ">");
 
     // 检测是否是删除操作
-    static QString lastText = "";
-    bool isDeleting = (newText.length() < lastText.length());
+    bool isDeleting = (newText.length() < m_lastText.length());
 
     if (isDeleting && cursor > 0 && cursor <= newText.length()){
         QChar charAtCursor = newText[cursor - 1];
@@ -117,9 +254,10 @@ void MainWindow::onExprTextEdited(const QString &text){
         }
     }
 
+    m_tracer.record(LatencyTracer::Stage::Filter, filterTimer.nsecsElapsed());
     const QString normalized = normalizeExpression(newText);
 
-    lastText = normalized;
+    m_lastText = normalized;
 
     if (normalized == text && newText == text) return;
 
@@ -157,6 +295,7 @@ void MainWindow::onExprTextEdited(const QString &text){
 
     ui->exprLineEdit->setText(normalized);
     ui->exprLineEdit->setCursorPosition(newCursor);
+    repaintTraced(ui->exprLineEdit);
 
     m_updatingText = false;
 }
@@ -165,6 +304,7 @@ void MainWindow::onAnyButtonClicked(){
     if (!b) return;
 
     const QString name = b->objectName();
+    m_session.recordClick(name);
 
     if (name == "btnClear"){
         clearAll();
@@ -201,7 +341,8 @@ void MainWindow::onAnyButtonClicked(){
         insertToExpr("^");
         return;
     }
-    static const QSet<QString> ops {"+","-","*","/","%","^","(",")","!","<<",">>"};
+    static const QSet<QString> ops {"+","-","*","/","%","^","(",")","!","<<",">>",
+                                    "POPCNT","CLZ","CTZ","PARITY","BSWAP","BITREV","ROL","ROR","PEXT","PDEP","INV","MOD"};
     if (ops.contains(t)){
         insertToExpr(" "+t+" ");
     } else {
@@ -217,6 +358,7 @@ void MainWindow::insertToExpr(const QString &s){
     m_updatingText = true;
     ui->exprLineEdit->setText(normalized);
     ui->exprLineEdit->setCursorPosition(normalized.length());
+    repaintTraced(ui->exprLineEdit);
     m_updatingText = false;
 }
 
@@ -233,7 +375,12 @@ void MainWindow::backspaceExpr(){
         return;
     }
 
-    if (text.endsWith("<<") || text.endsWith(">>") || text.endsWith("^^")){
+    // 关键字整个删除
+    static const QRegularExpression keywordRe("(POPCNT|CLZ|CTZ|PARITY|BSWAP|BITREV|ROL|ROR|PEXT|PDEP|INV|MOD)$");
+    const QRegularExpressionMatch keyword = keywordRe.match(text);
+    if (keyword.hasMatch()){
+        text.chop(keyword.capturedLength());
+    } else if (text.endsWith("<<") || text.endsWith(">>") || text.endsWith("^^")){
         text.chop(2);
     } else {
         text.chop(1);
@@ -248,6 +395,7 @@ void MainWindow::backspaceExpr(){
     m_updatingText = true;
     ui->exprLineEdit->setText(normalized);
     ui->exprLineEdit->setCursorPosition(normalized.length());
+    repaintTraced(ui->exprLineEdit);
     m_updatingText = false;
 }
 
@@ -257,6 +405,7 @@ void MainWindow::clearAll(){
 }
 
 QString MainWindow::normalizeExpression(const QString &in) const{
+    LatencyTracer::Scope scope(m_tracer, LatencyTracer::Stage::Normalize);
     QString s = in. toUpper();
 
     s.replace(QRegularExpression("\\s+"), " ");
@@ -285,6 +434,9 @@ QString MainWindow::normalizeExpression(const QString &in) const{
 
     s. replace(QRegularExpression("(?<!\\^)\\^(?!\\^)"), " ^ ");
 
+    static const QRegularExpression keywordRe("(POPCNT|CLZ|CTZ|PARITY|BSWAP|BITREV|ROL|ROR|PEXT|PDEP|INV|MOD)");
+    s.replace(keywordRe, " \\1 ");
+
     s.replace(QRegularExpression("\\^\\s+\\^"), "^^");
     s.replace("^^", " ^^ ");
 
@@ -297,11 +449,22 @@ QString MainWindow::normalizeExpression(const QString &in) const{
 void MainWindow::computeAndShow(){
     const QString expr = normalizeExpression(ui->exprLineEdit->text());
 
-    CalculatorCore::Result res = m_calc.compute(expr);
+    CalculatorCore::Result res;
+    {
+        LatencyTracer::Scope scope(m_tracer, LatencyTracer::Stage::Compute);
+        res = m_calc.compute(expr);
+    }
 
     ui->exprLineEdit->setText(expr);
     ui->resultLineEdit->setText(res.valueStr);
+    repaintTraced(ui->exprLineEdit);
+    repaintTraced(ui->resultLineEdit);
 
     ui->exprLineEdit->setFocus();
-    ui->exprLineEdit->setCursorPosition(ui->exprLineEdit->text().length());
+    // 选中出错的 token
+    if (res.isError && res.errorLength > 0){
+        ui->exprLineEdit->setSelection(res.errorStart, res.errorLength);
+    } else {
+        ui->exprLineEdit->setCursorPosition(ui->exprLineEdit->text().length());
+    }
 }
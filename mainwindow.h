@@ -3,6 +3,10 @@
 
 #include <QMainWindow>
 #include "calculatorcore.h"
+#include "latencytracer.h"
+#include "sessionlog.h"
+
+class QComboBox;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -18,12 +22,23 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    void setBackend(CalculatorCore::Backend backend);
+
+    // 按录制顺序重放按键会话, 用于离屏的延迟回归测试
+    bool replaySession(const QString &path, int repeat, QString &err);
+    const LatencyTracer &tracer() const { return m_tracer; }
+
 private slots:
     void onAnyButtonClicked();
     void onExprReturnPressed();
     void onExprTextEdited(const QString &text);
+    void onBackendChanged(const QString &name);
+    void onRecordToggled(bool checked);
+    void showLatencyReport();
 
 private:
+    void setupBackendSelector();
+    void setupTracingControls();
     void setupConnections();
     void computeAndShow();
 
@@ -31,10 +46,15 @@ private:
     void backspaceExpr();
     void clearAll();
     QString normalizeExpression(const QString &in) const;
+    void repaintTraced(QWidget *w);
 
 private:
     Ui::MainWindow *ui;
     CalculatorCore m_calc;
+    QComboBox *m_backendBox = nullptr;
     bool m_updatingText = false;
+    QString m_lastText;
+    mutable LatencyTracer m_tracer;
+    SessionLog m_session;
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,99 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile(){
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path, HexErrorCode &err){
+    close();
+
+    const int wlen = MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), nullptr, 0);
+    std::wstring wpath(static_cast<std::size_t>(wlen), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), &wpath[0], wlen);
+
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE){
+        err = HexErrorCode::FileOpenFailed;
+        return false;
+    }
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)){
+        err = HexErrorCode::FileOpenFailed;
+        close();
+        return false;
+    }
+    m_size = size.QuadPart;
+    if (m_size == 0) return true;
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view){
+        err = HexErrorCode::FileMapFailed;
+        close();
+        return false;
+    }
+    m_data = static_cast<const std::uint8_t *>(view);
+    return true;
+}
+
+void MappedFile::close(){
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path, HexErrorCode &err){
+    close();
+
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (m_fd < 0 || ::fstat(m_fd, &st) != 0){
+        err = HexErrorCode::FileOpenFailed;
+        close();
+        return false;
+    }
+    m_size = static_cast<std::int64_t>(st.st_size);
+    if (m_size == 0) return true;
+
+    void *p = ::mmap(nullptr, static_cast<std::size_t>(m_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (p == MAP_FAILED){
+        err = HexErrorCode::FileMapFailed;
+        close();
+        return false;
+    }
+    m_data = static_cast<const std::uint8_t *>(p);
+    return true;
+}
+
+void MappedFile::close(){
+    if (m_data) ::munmap(const_cast<std::uint8_t *>(m_data), static_cast<std::size_t>(m_size));
+    if (m_fd >= 0) ::close(m_fd);
+    m_data = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "hexerror.h"
+#include <cstdint>
+#include <string>
+
+// 只读内存映射文件, 不依赖 Qt
+// path 为 UTF-8, Windows 上转换为宽字符后打开
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // 失败时 err 为 FileOpenFailed / FileMapFailed
+    bool open(const std::string &path, HexErrorCode &err);
+    void close();
+
+    // 空文件不做映射, data() 为 nullptr
+    const std::uint8_t *data() const { return m_data; }
+    std::int64_t size() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+    const std::uint8_t *m_data = nullptr;
+    std::int64_t m_size = 0;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,491 @@
+#include "modarith.h"
+#include "bitops.h"
+#include "hexscan.h"
+#include "numericbackend.h"
+#include <algorithm>
+
+namespace {
+
+using Limbs = std::vector<std::uint64_t>;
+
+// a + b * c + carry, 返回低 64 位, 高 64 位写回 carry (不会溢出)
+inline std::uint64_t mulAdd(std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t &carry){
+    std::uint64_t hi;
+    std::uint64_t lo = mulWide(b, c, hi);
+    lo += a;
+    hi += lo < a;
+    lo += carry;
+    hi += lo < carry;
+    carry = hi;
+    return lo;
+}
+
+int compare(const std::uint64_t *a, const std::uint64_t *b, std::size_t n){
+    for (std::size_t i = n; i-- > 0;){
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+std::uint64_t addTo(std::uint64_t *out, const std::uint64_t *a, const std::uint64_t *b, std::size_t n){
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < n; i++){
+        const std::uint64_t s = a[i] + carry;
+        carry = s < carry;
+        out[i] = s + b[i];
+        carry += out[i] < s;
+    }
+    return carry;
+}
+
+std::uint64_t subFrom(std::uint64_t *out, const std::uint64_t *a, const std::uint64_t *b, std::size_t n){
+    std::uint64_t borrow = 0;
+    for (std::size_t i = 0; i < n; i++){
+        const std::uint64_t d = a[i] - b[i];
+        const std::uint64_t nb = (a[i] < b[i]) | (d < borrow);
+        out[i] = d - borrow;
+        borrow = nb;
+    }
+    return borrow;
+}
+
+// out 为 an + bn 个字, 不能与输入重叠
+void mulFull(std::uint64_t *out, const std::uint64_t *a, std::size_t an, const std::uint64_t *b, std::size_t bn){
+    std::fill(out, out + an + bn, 0);
+    for (std::size_t i = 0; i < an; i++){
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j < bn; j++) out[i + j] = mulAdd(out[i + j], a[i], b[j], carry);
+        out[i + bn] = carry;
+    }
+}
+
+void trim(Limbs &v){
+    while (!v.empty() && v.back() == 0) v.pop_back();
+}
+
+Limbs mulLimbs(const Limbs &a, const Limbs &b){
+    if (a.empty() || b.empty()) return Limbs();
+    Limbs out(a.size() + b.size());
+    mulFull(out.data(), a.data(), a.size(), b.data(), b.size());
+    trim(out);
+    return out;
+}
+
+Limbs addLimbs(const Limbs &a, const Limbs &b){
+    const Limbs &x = a.size() >= b.size() ? a : b;
+    const Limbs &y = a.size() >= b.size() ? b : a;
+    Limbs out(x.size() + 1, 0);
+    Limbs yy(y);
+    yy.resize(x.size(), 0);
+    out[x.size()] = addTo(out.data(), x.data(), yy.data(), x.size());
+    trim(out);
+    return out;
+}
+
+std::vector<std::uint32_t> toDigits(const Limbs &v){
+    std::vector<std::uint32_t> d;
+    d.reserve(v.size() * 2);
+    for (std::uint64_t w : v){
+        d.push_back(static_cast<std::uint32_t>(w));
+        d.push_back(static_cast<std::uint32_t>(w >> 32));
+    }
+    while (!d.empty() && d.back() == 0) d.pop_back();
+    return d;
+}
+
+Limbs fromDigits(const std::vector<std::uint32_t> &d){
+    Limbs v((d.size() + 1) / 2, 0);
+    for (std::size_t i = 0; i < d.size(); i++) v[i / 2] |= static_cast<std::uint64_t>(d[i]) << (32 * (i % 2));
+    trim(v);
+    return v;
+}
+
+// u = q * v + r, Knuth 算法 D, 按 32 位数字计算; v 不能为 0, q 可以为空
+// 只在设置模数 / 转换常数 / 求逆时使用, 允许分配内存
+void divRem(const Limbs &u64s, const Limbs &v64s, Limbs *q64, Limbs &r64){
+    const std::vector<std::uint32_t> u = toDigits(u64s);
+    const std::vector<std::uint32_t> v = toDigits(v64s);
+    const std::size_t m = u.size();
+    const std::size_t n = v.size();
+    if (m < n){
+        if (q64) q64->clear();
+        r64 = u64s;
+        trim(r64);
+        return;
+    }
+
+    std::vector<std::uint32_t> q(m - n + 1, 0);
+    std::vector<std::uint32_t> r(n, 0);
+
+    if (n == 1){
+        std::uint64_t k = 0;
+        for (std::size_t j = m; j-- > 0;){
+            const std::uint64_t cur = (k << 32) | u[j];
+            q[j] = static_cast<std::uint32_t>(cur / v[0]);
+            k = cur % v[0];
+        }
+        r[0] = static_cast<std::uint32_t>(k);
+    } else {
+        // 规格化: 除数最高位移到第 31 位
+        const int s = bitClz(v[n - 1]) - 32;
+        std::vector<std::uint32_t> vn(n);
+        std::vector<std::uint32_t> un(m + 1);
+        for (std::size_t i = n - 1; i > 0; i--)
+            vn[i] = (v[i] << s) | static_cast<std::uint32_t>(static_cast<std::uint64_t>(v[i - 1]) >> (32 - s));
+        vn[0] = v[0] << s;
+        un[m] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(u[m - 1]) >> (32 - s));
+        for (std::size_t i = m - 1; i > 0; i--)
+            un[i] = (u[i] << s) | static_cast<std::uint32_t>(static_cast<std::uint64_t>(u[i - 1]) >> (32 - s));
+        un[0] = u[0] << s;
+
+        for (std::size_t j = m - n + 1; j-- > 0;){
+            // 估计商的这一位, 最多偏大 2
+            const std::uint64_t num = (static_cast<std::uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+            std::uint64_t qhat = num / vn[n - 1];
+            std::uint64_t rhat = num % vn[n - 1];
+            while ((qhat >> 32) != 0 || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])){
+                qhat--;
+                rhat += vn[n - 1];
+                if ((rhat >> 32) != 0) break;
+            }
+
+            // 减去 qhat * v
+            std::int64_t borrow = 0;
+            std::int64_t t = 0;
+            for (std::size_t i = 0; i < n; i++){
+                const std::uint64_t p = qhat * vn[i];
+                t = static_cast<std::int64_t>(un[i + j]) - borrow - static_cast<std::int64_t>(p & 0xFFFFFFFFu);
+                un[i + j] = static_cast<std::uint32_t>(t);
+                borrow = static_cast<std::int64_t>(p >> 32) - (t >> 32);
+            }
+            t = static_cast<std::int64_t>(un[j + n]) - borrow;
+            un[j + n] = static_cast<std::uint32_t>(t);
+
+            q[j] = static_cast<std::uint32_t>(qhat);
+            if (t < 0){
+                // 减多了, 加回一个 v
+                q[j]--;
+                std::uint64_t c = 0;
+                for (std::size_t i = 0; i < n; i++){
+                    c += static_cast<std::uint64_t>(un[i + j]) + vn[i];
+                    un[i + j] = static_cast<std::uint32_t>(c);
+                    c >>= 32;
+                }
+                un[j + n] += static_cast<std::uint32_t>(c);
+            }
+        }
+
+        for (std::size_t i = 0; i + 1 < n; i++)
+            r[i] = (un[i] >> s) | static_cast<std::uint32_t>(static_cast<std::uint64_t>(un[i + 1]) << (32 - s));
+        r[n - 1] = un[n - 1] >> s;
+    }
+
+    if (q64) *q64 = fromDigits(q);
+    r64 = fromDigits(r);
+}
+
+// 指数的位数对应的窗口大小
+int windowBits(std::size_t bits){
+    if (bits > 671) return 6;
+    if (bits > 239) return 5;
+    if (bits > 79) return 4;
+    if (bits > 23) return 3;
+    return 1;
+}
+
+inline bool testBit(const std::uint64_t *e, std::size_t i){
+    return (e[i / 64] >> (i % 64)) & 1;
+}
+
+} // namespace
+
+bool ModContext::parseHex(std::string_view digits, std::vector<std::uint64_t> &out, HexErrorCode &err){
+    out.clear();
+    out.reserve(digits.size() / 16 + 1);
+    // 从低位开始每 16 位一组
+    std::size_t end = digits.size();
+    while (end > 0){
+        const std::size_t start = end >= 16 ? end - 16 : 0;
+        std::uint64_t w = 0;
+        if (!hexToWord(digits.data() + start, end - start, w)){
+            err = HexErrorCode::InvalidIntegerDigit;
+            return false;
+        }
+        out.push_back(w);
+        end = start;
+    }
+    trim(out);
+    return true;
+}
+
+bool ModContext::setModulus(std::string_view hexDigits, HexErrorCode &err){
+    Limbs n;
+    if (!parseHex(hexDigits, n, err)) return false;
+    if (n.empty() || (n.size() == 1 && n[0] < 2)){
+        err = HexErrorCode::InvalidModulus;
+        return false;
+    }
+
+    const std::size_t k = n.size();
+    m_n = n;
+    m_montgomery = (n[0] & 1) != 0;
+    m_powerOfTwo = (n.back() & (n.back() - 1)) == 0 && std::all_of(n.begin(), n.end() - 1, [](std::uint64_t w){ return w == 0; });
+    m_unit.assign(k, 0);
+    m_unit[0] = 1;
+
+    Limbs rem;
+    if (m_montgomery){
+        // 牛顿迭代求 N^-1 mod 2^64, 每次正确位数翻倍
+        std::uint64_t inv = n[0];
+        for (int i = 0; i < 5; i++) inv *= 2 - n[0] * inv;
+        m_n0inv = 0 - inv;
+
+        Limbs r(k + 1, 0);
+        r[k] = 1;
+        divRem(r, n, nullptr, rem);
+        rem.resize(k, 0);
+        m_one = rem;
+
+        Limbs r2(2 * k + 1, 0);
+        r2[2 * k] = 1;
+        divRem(r2, n, nullptr, rem);
+        rem.resize(k, 0);
+        m_r2 = rem;
+        m_mu.clear();
+    } else if (m_powerOfTwo){
+        // 2 的幂直接截断, 也避免 N = 2^(64(k-1)) 时 mu 超出 k + 1 个字
+        m_one = m_unit;
+        m_r2.clear();
+        m_mu.clear();
+    } else {
+        Limbs b2k(2 * k + 1, 0);
+        b2k[2 * k] = 1;
+        divRem(b2k, n, &m_mu, rem);
+        m_mu.resize(k + 1, 0);
+        m_one = m_unit;
+        m_r2.clear();
+    }
+
+    m_prod.assign(2 * k + 2, 0);
+    m_work.assign(4 * k + 3, 0);
+    m_table.assign(32 * k, 0);
+    m_acc.assign(k, 0);
+    return true;
+}
+
+void ModContext::montMul(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const{
+    const std::size_t k = m_n.size();
+    const std::uint64_t *n = m_n.data();
+
+    if (k == 1){
+        // 单字模: 一次 128 位乘积, 一次约简
+        std::uint64_t hi;
+        const std::uint64_t lo = mulWide(a[0], b[0], hi);
+        std::uint64_t mhi;
+        mulWide(lo * m_n0inv, n[0], mhi);
+        // lo + m * N 的低 64 位为 0, lo 非 0 时进位
+        std::uint64_t r = hi + mhi;
+        bool over = r < hi;
+        const std::uint64_t c = lo != 0;
+        r += c;
+        over |= r < c;
+        out[0] = over || r >= n[0] ? r - n[0] : r;
+        return;
+    }
+
+    // CIOS: 逐字相乘并立即约简, t 最多 k + 2 个字
+    std::uint64_t *t = m_prod.data();
+    std::fill(t, t + k + 2, 0);
+    for (std::size_t i = 0; i < k; i++){
+        std::uint64_t c = 0;
+        for (std::size_t j = 0; j < k; j++) t[j] = mulAdd(t[j], a[j], b[i], c);
+        std::uint64_t s = t[k] + c;
+        t[k + 1] = s < c;
+        t[k] = s;
+
+        const std::uint64_t m = t[0] * m_n0inv;
+        c = 0;
+        mulAdd(t[0], m, n[0], c);
+        for (std::size_t j = 1; j < k; j++) t[j - 1] = mulAdd(t[j], m, n[j], c);
+        s = t[k] + c;
+        t[k - 1] = s;
+        t[k] = t[k + 1] + (s < c);
+    }
+
+    if (t[k] != 0 || compare(t, n, k) >= 0) subFrom(out, t, n, k);
+    else std::copy(t, t + k, out);
+}
+
+void ModContext::reduce(std::uint64_t *out) const{
+    // Barrett: x 为 m_prod 中的 2k 个字, x < N^2
+    const std::size_t k = m_n.size();
+    const std::uint64_t *x = m_prod.data();
+    if (m_powerOfTwo){
+        std::copy(x, x + k, out);
+        out[k - 1] &= m_n[k - 1] - 1;
+        return;
+    }
+    std::uint64_t *q2 = m_work.data();              // 2k + 2
+    std::uint64_t *r2 = m_work.data() + 2 * k + 2;  // 2k + 1
+
+    // q3 = floor(floor(x / b^(k-1)) * mu / b^(k+1))
+    mulFull(q2, x + k - 1, k + 1, m_mu.data(), k + 1);
+    const std::uint64_t *q3 = q2 + k + 1;
+    // r = (x - q3 * N) mod b^(k+1), 最多比 N 大 2 倍
+    mulFull(r2, q3, k + 1, m_n.data(), k);
+    subFrom(r2, x, r2, k + 1);
+    while (r2[k] != 0 || compare(r2, m_n.data(), k) >= 0){
+        r2[k] -= subFrom(r2, r2, m_n.data(), k);
+    }
+    std::copy(r2, r2 + k, out);
+}
+
+void ModContext::toPlain(const std::uint64_t *a, std::uint64_t *out) const{
+    if (m_montgomery) montMul(a, m_unit.data(), out);
+    else std::copy(a, a + m_n.size(), out);
+}
+
+void ModContext::fromPlain(const std::uint64_t *a, std::uint64_t *out) const{
+    if (m_montgomery) montMul(a, m_r2.data(), out);
+    else std::copy(a, a + m_n.size(), out);
+}
+
+bool ModContext::fromHex(std::string_view digits, std::uint64_t *out, HexErrorCode &err) const{
+    Limbs &x = m_parsed;
+    if (!parseHex(digits, x, err)) return false;
+    // 常数通常已经小于 N, 不用做除法, 也不分配内存
+    const std::size_t k = m_n.size();
+    if (x.size() <= k){
+        x.resize(k, 0);
+        if (compare(x.data(), m_n.data(), k) < 0){
+            fromPlain(x.data(), out);
+            return true;
+        }
+    }
+    Limbs r;
+    divRem(x, m_n, nullptr, r);
+    r.resize(m_n.size(), 0);
+    fromPlain(r.data(), out);
+    return true;
+}
+
+void ModContext::toHex(const std::uint64_t *a, std::string &out) const{
+    static const char digits[] = "0123456789ABCDEF";
+    std::uint64_t *v = m_acc.data();
+    std::size_t size = m_n.size();
+    toPlain(a, v);
+    while (size > 0 && v[size - 1] == 0) size--;
+    if (size == 0){
+        out += '0';
+        return;
+    }
+
+    bool leading = true;
+    for (std::size_t i = size; i-- > 0;){
+        for (int shift = 60; shift >= 0; shift -= 4){
+            const unsigned d = static_cast<unsigned>(v[i] >> shift) & 0xF;
+            if (leading && d == 0) continue;
+            leading = false;
+            out += digits[d];
+        }
+    }
+}
+
+void ModContext::add(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const{
+    const std::size_t k = m_n.size();
+    const std::uint64_t carry = addTo(out, a, b, k);
+    if (carry || compare(out, m_n.data(), k) >= 0) subFrom(out, out, m_n.data(), k);
+}
+
+void ModContext::sub(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const{
+    const std::size_t k = m_n.size();
+    if (subFrom(out, a, b, k)) addTo(out, out, m_n.data(), k);
+}
+
+void ModContext::mul(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const{
+    if (m_montgomery){
+        montMul(a, b, out);
+        return;
+    }
+    const std::size_t k = m_n.size();
+    mulFull(m_prod.data(), a, k, b, k);
+    reduce(out);
+}
+
+void ModContext::pow(const std::uint64_t *base, const std::uint64_t *exp, std::size_t expLimbs, std::uint64_t *out) const{
+    const std::size_t k = m_n.size();
+    while (expLimbs > 0 && exp[expLimbs - 1] == 0) expLimbs--;
+    if (expLimbs == 0){
+        std::copy(m_one.begin(), m_one.end(), out);
+        return;
+    }
+    const std::size_t bits = 64 * expLimbs - static_cast<std::size_t>(bitClz(exp[expLimbs - 1]));
+
+    // 奇数次幂表: base, base^3, base^5 ... base^(2^w - 1)
+    const int w = windowBits(bits);
+    const std::size_t entries = std::size_t(1) << (w - 1);
+    std::uint64_t *table = m_table.data();
+    std::copy(base, base + k, table);
+    if (entries > 1){
+        std::uint64_t *sq = m_acc.data();
+        mul(base, base, sq);
+        for (std::size_t e = 1; e < entries; e++) mul(table + (e - 1) * k, sq, table + e * k);
+    }
+
+    // 从高位开始, 连续的 0 只平方, 遇到 1 取不超过 w 位且以 1 结尾的窗口查表
+    bool started = false;
+    std::size_t i = bits;
+    while (i > 0){
+        if (!testBit(exp, i - 1)){
+            if (started) mul(out, out, out);
+            i--;
+            continue;
+        }
+        std::size_t j = i > static_cast<std::size_t>(w) ? i - static_cast<std::size_t>(w) : 0;
+        while (!testBit(exp, j)) j++;
+
+        std::size_t value = 0;
+        for (std::size_t b = i; b-- > j;) value = (value << 1) | (testBit(exp, b) ? 1 : 0);
+        const std::uint64_t *entry = table + ((value - 1) / 2) * k;
+        if (started){
+            for (std::size_t s = j; s < i; s++) mul(out, out, out);
+            mul(out, entry, out);
+        } else {
+            std::copy(entry, entry + k, out);
+            started = true;
+        }
+        i = j;
+    }
+}
+
+bool ModContext::inverse(const std::uint64_t *a, std::uint64_t *out) const{
+    const std::size_t k = m_n.size();
+    Limbs x(k);
+    toPlain(a, x.data());
+    trim(x);
+    if (x.empty()) return false;
+
+    // 扩展欧几里得, 只跟踪 x 的系数; 系数的符号依次交替, 只记录绝对值
+    Limbs r0(m_n), r1(x);
+    Limbs t0, t1 { 1 };
+    bool neg0 = false, neg1 = false;
+    Limbs q, r;
+    while (!r1.empty()){
+        divRem(r0, r1, &q, r);
+        r0.swap(r1);
+        r1.swap(r);
+
+        Limbs t = addLimbs(t0, mulLimbs(q, t1));
+        t0.swap(t1);
+        t1.swap(t);
+        const bool neg = !neg1;
+        neg0 = neg1;
+        neg1 = neg;
+    }
+    if (r0.size() != 1 || r0[0] != 1) return false;
+
+    t0.resize(k, 0);
+    if (neg0) subFrom(t0.data(), m_n.data(), t0.data(), k);
+    fromPlain(t0.data(), out);
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef MODARITH_H
+#define MODARITH_H
+
+#include "hexerror.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 模 N 整数运算, N 为任意长度的正整数, 按 64 位字存放, 低位在前
+// 奇数模用 Montgomery 乘法 (单字模有单独的 64 位路径), 偶数模用 Barrett 约简, 2 的幂直接截断
+// 元素按内部表示 (Montgomery 形式 / 普通余数) 存放, 每个占 limbs() 个字, 由调用方分配;
+// 加减乘 / 幂运算使用 setModulus() 时准备好的缓冲区, 不分配内存
+// 内部缓冲区不是线程安全的, 同一个实例不要跨线程同时使用
+class ModContext
+{
+public:
+    // 模数的十六进制数字, 必须 >= 2
+    bool setModulus(std::string_view hexDigits, HexErrorCode &err);
+
+    std::size_t limbs() const { return m_n.size(); }
+    bool isMontgomery() const { return m_montgomery; }
+
+    // 任意长度的十六进制整数 -> 低位在前的字, 去掉高位的 0
+    static bool parseHex(std::string_view digits, std::vector<std::uint64_t> &out, HexErrorCode &err);
+
+    // 任意长度的十六进制整数, 约简后转成内部表示
+    bool fromHex(std::string_view digits, std::uint64_t *out, HexErrorCode &err) const;
+    // 按 [0, N) 中的值输出十六进制, 不带前导 0
+    void toHex(const std::uint64_t *a, std::string &out) const;
+
+    // out 可以和输入是同一块内存
+    void add(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const;
+    void sub(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const;
+    void mul(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const;
+    // 滑动窗口模幂, exp 是普通整数 (不是内部表示), 低位在前
+    void pow(const std::uint64_t *base, const std::uint64_t *exp, std::size_t expLimbs, std::uint64_t *out) const;
+    // 扩展欧几里得求逆元, 与 N 不互素时返回 false
+    bool inverse(const std::uint64_t *a, std::uint64_t *out) const;
+
+private:
+    void reduce(std::uint64_t *out) const;
+    void montMul(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *out) const;
+    void toPlain(const std::uint64_t *a, std::uint64_t *out) const;
+    void fromPlain(const std::uint64_t *a, std::uint64_t *out) const;
+
+    std::vector<std::uint64_t> m_n;
+    bool m_montgomery = false;
+    bool m_powerOfTwo = false;
+    // Montgomery: -N^-1 mod 2^64, R^2 mod N, 1 的内部表示 (R mod N)
+    std::uint64_t m_n0inv = 0;
+    std::vector<std::uint64_t> m_r2;
+    std::vector<std::uint64_t> m_one;
+    std::vector<std::uint64_t> m_unit;              // 普通的 1, 转回普通表示时用
+    // Barrett: floor(2^(128k) / N), k = limbs()
+    std::vector<std::uint64_t> m_mu;
+
+    mutable std::vector<std::uint64_t> m_prod;      // 乘积 / 约简的临时空间
+    mutable std::vector<std::uint64_t> m_work;
+    mutable std::vector<std::uint64_t> m_table;     // 滑动窗口的奇数次幂表
+    mutable std::vector<std::uint64_t> m_acc;
+    mutable std::vector<std::uint64_t> m_parsed;    // fromHex() 解析出的常数
+};
+
+#endif // MODARITH_H
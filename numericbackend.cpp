@@ -0,0 +1,219 @@
+#include "numericbackend.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+std::uint64_t mulWide(std::uint64_t a, std::uint64_t b, std::uint64_t &hi){
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+    hi = static_cast<std::uint64_t>(p >> 64);
+    return static_cast<std::uint64_t>(p);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, &hi);
+#else
+    const std::uint64_t aL = a & 0xFFFFFFFFu, aH = a >> 32;
+    const std::uint64_t bL = b & 0xFFFFFFFFu, bH = b >> 32;
+    const std::uint64_t ll = aL * bL, lh = aL * bH, hl = aH * bL, hh = aH * bH;
+    const std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (ll & 0xFFFFFFFFu);
+#endif
+}
+
+namespace {
+
+struct U128 {
+    std::uint64_t hi;
+    std::uint64_t lo;
+};
+
+U128 negate(U128 v){
+    const std::uint64_t lo = ~v.lo + 1;
+    const std::uint64_t hi = ~v.hi + (lo == 0 ? 1 : 0);
+    return { hi, lo };
+}
+
+U128 magnitude(const Fixed64 &v){
+    const U128 raw { v.hi(), v.lo() };
+    return v.isNegative() ? negate(raw) : raw;
+}
+
+bool lessThan(U128 a, U128 b){
+    return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+U128 sub(U128 a, U128 b){
+    const std::uint64_t lo = a.lo - b.lo;
+    const std::uint64_t hi = a.hi - b.hi - (a.lo < b.lo ? 1 : 0);
+    return { hi, lo };
+}
+
+U128 shiftLeft(U128 v, int bits){
+    if (bits >= 128) return { 0, 0 };
+    if (bits >= 64) return { v.lo << (bits - 64), 0 };
+    if (bits == 0) return v;
+    return { (v.hi << bits) | (v.lo >> (64 - bits)), v.lo << bits };
+}
+
+U128 shiftRight(U128 v, int bits){
+    if (bits >= 128) return { 0, 0 };
+    if (bits >= 64) return { 0, v.hi >> (bits - 64) };
+    if (bits == 0) return v;
+    return { v.hi >> bits, (v.lo >> bits) | (v.hi << (64 - bits)) };
+}
+
+// 有符号结果: 幅值不得超过 2^127 (负数时允许恰好 2^127)
+Fixed64 fromMagnitude(U128 m, bool neg){
+    const std::uint64_t signBit = 1ull << 63;
+    if (m.hi > signBit || (m.hi == signBit && (m.lo != 0 || !neg))) return Fixed64::overflowed();
+    const U128 r = neg ? negate(m) : m;
+    return Fixed64::fromRaw(r.hi, r.lo);
+}
+
+// 逐位恢复余数除法, 被除数 words[0] 为最高位字
+void divide(const std::uint64_t *words, int count, U128 d, std::uint64_t *quot, U128 &rem){
+    rem = { 0, 0 };
+    for (int w = 0; w < count; w++){
+        quot[w] = 0;
+        for (int bit = 63; bit >= 0; bit--){
+            const bool carry = (rem.hi >> 63) != 0;
+            rem.hi = (rem.hi << 1) | (rem.lo >> 63);
+            rem.lo = (rem.lo << 1) | ((words[w] >> bit) & 1);
+            if (carry || !lessThan(rem, d)){
+                rem = sub(rem, d);
+                quot[w] |= 1ull << bit;
+            }
+        }
+    }
+}
+
+} // namespace
+
+Fixed64 Fixed64::fromRaw(std::uint64_t hi, std::uint64_t lo, bool ovf){
+    Fixed64 v;
+    v.m_hi = hi;
+    v.m_lo = lo;
+    v.m_ovf = ovf;
+    return v;
+}
+
+Fixed64 Fixed64::fromInt(long long v){
+    return fromRaw(static_cast<std::uint64_t>(v), 0);
+}
+
+Fixed64 Fixed64::fromLongDouble(long double v){
+    const long double limit = std::ldexp(1.0L, 63);
+    if (!std::isfinite(v) || v >= limit || v < -limit) return overflowed();
+    const long double fl = std::floor(v);
+    const long double frac = v - fl;
+    return fromRaw(static_cast<std::uint64_t>(static_cast<long long>(fl)),
+                   static_cast<std::uint64_t>(std::ldexp(frac, 64)));
+}
+
+Fixed64 Fixed64::overflowed(){
+    return fromRaw(0, 0, true);
+}
+
+long double Fixed64::toLongDouble() const{
+    if (m_ovf) return std::numeric_limits<long double>::infinity();
+    return static_cast<long double>(static_cast<std::int64_t>(m_hi))
+           + std::ldexp(static_cast<long double>(m_lo), -64);
+}
+
+Fixed64 Fixed64::operator-() const{
+    if (m_ovf) return overflowed();
+    if (m_hi == (1ull << 63) && m_lo == 0) return overflowed();
+    const U128 r = negate({ m_hi, m_lo });
+    return fromRaw(r.hi, r.lo);
+}
+
+Fixed64 Fixed64::operator+(const Fixed64 &o) const{
+    if (m_ovf || o.m_ovf) return overflowed();
+    const std::uint64_t lo = m_lo + o.m_lo;
+    const std::uint64_t hi = m_hi + o.m_hi + (lo < m_lo ? 1 : 0);
+    // 同号相加结果变号即溢出
+    if (isNegative() == o.isNegative() && (static_cast<std::int64_t>(hi) < 0) != isNegative()) return overflowed();
+    return fromRaw(hi, lo);
+}
+
+Fixed64 Fixed64::operator-(const Fixed64 &o) const{
+    if (m_ovf || o.m_ovf) return overflowed();
+    const std::uint64_t lo = m_lo - o.m_lo;
+    const std::uint64_t hi = m_hi - o.m_hi - (m_lo < o.m_lo ? 1 : 0);
+    // 异号相减结果符号与被减数不同即溢出
+    if (isNegative() != o.isNegative() && (static_cast<std::int64_t>(hi) < 0) != isNegative()) return overflowed();
+    return fromRaw(hi, lo);
+}
+
+Fixed64 Fixed64::operator*(const Fixed64 &o) const{
+    if (m_ovf || o.m_ovf) return overflowed();
+    const U128 a = magnitude(*this);
+    const U128 b = magnitude(o);
+
+    // 256 位乘积 w3:w2:w1:w0, 取中间 128 位即为 64.64 结果
+    std::uint64_t h00, h01, h10, h11;
+    const std::uint64_t l00 = mulWide(a.lo, b.lo, h00);
+    const std::uint64_t l01 = mulWide(a.lo, b.hi, h01);
+    const std::uint64_t l10 = mulWide(a.hi, b.lo, h10);
+    const std::uint64_t l11 = mulWide(a.hi, b.hi, h11);
+    (void)l00;
+
+    std::uint64_t w1 = h00;
+    std::uint64_t carry2 = 0;
+    w1 += l01; carry2 += (w1 < l01);
+    w1 += l10; carry2 += (w1 < l10);
+
+    std::uint64_t w2 = h01;
+    std::uint64_t carry3 = 0;
+    w2 += h10; carry3 += (w2 < h10);
+    w2 += l11; carry3 += (w2 < l11);
+    w2 += carry2; carry3 += (w2 < carry2);
+
+    const std::uint64_t w3 = h11 + carry3;
+    if (w3 != 0) return overflowed();
+    return fromMagnitude({ w2, w1 }, isNegative() != o.isNegative());
+}
+
+Fixed64 Fixed64::operator/(const Fixed64 &o) const{
+    if (m_ovf || o.m_ovf || o.isZero()) return overflowed();
+    const U128 a = magnitude(*this);
+    const U128 b = magnitude(o);
+
+    // (|a| << 64) / |b|
+    const std::uint64_t dividend[3] = { a.hi, a.lo, 0 };
+    std::uint64_t quot[3];
+    U128 rem;
+    divide(dividend, 3, b, quot, rem);
+    if (quot[0] != 0) return overflowed();
+    return fromMagnitude({ quot[1], quot[2] }, isNegative() != o.isNegative());
+}
+
+Fixed64 Fixed64::rem(const Fixed64 &o) const{
+    if (m_ovf || o.m_ovf || o.isZero()) return overflowed();
+    const U128 a = magnitude(*this);
+    const U128 b = magnitude(o);
+
+    // 两个操作数缩放系数相同, 直接对原始值取余即可得到精确结果
+    const std::uint64_t dividend[2] = { a.hi, a.lo };
+    std::uint64_t quot[2];
+    U128 r;
+    divide(dividend, 2, b, quot, r);
+    return fromMagnitude(r, isNegative());
+}
+
+Fixed64 Fixed64::shifted(int bits) const{
+    if (m_ovf) return overflowed();
+    if (bits == 0 || isZero()) return *this;
+
+    const U128 m = magnitude(*this);
+    if (bits > 0){
+        if (bits >= 128) return overflowed();
+        const U128 r = shiftLeft(m, bits);
+        const U128 back = shiftRight(r, bits);
+        if (back.hi != m.hi || back.lo != m.lo) return overflowed();
+        return fromMagnitude(r, isNegative());
+    }
+    const int rbits = bits < -128 ? 128 : -bits;
+    return fromMagnitude(shiftRight(m, rbits), isNegative());
+}
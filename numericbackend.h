@@ -0,0 +1,157 @@
+#ifndef NUMERICBACKEND_H
+#define NUMERICBACKEND_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#ifdef HEXCALC_HAS_FLOAT128
+#include <quadmath.h>
+#endif
+
+// 64x64 -> 128 位乘法, 返回低 64 位, 高 64 位写入 hi
+std::uint64_t mulWide(std::uint64_t a, std::uint64_t b, std::uint64_t &hi);
+
+// 64.64 定点数: 128 位补码, hi 为整数部分, lo 为小数部分
+// 十六进制小数在 16 位以内可以精确表示; 溢出后置 ovf, 之后的运算结果都视为溢出
+class Fixed64
+{
+public:
+    Fixed64() = default;
+
+    static Fixed64 fromRaw(std::uint64_t hi, std::uint64_t lo, bool ovf = false);
+    static Fixed64 fromInt(long long v);
+    static Fixed64 fromLongDouble(long double v);
+    static Fixed64 overflowed();
+
+    long double toLongDouble() const;
+
+    std::uint64_t hi() const { return m_hi; }
+    std::uint64_t lo() const { return m_lo; }
+    bool isOverflow() const { return m_ovf; }
+    bool isNegative() const { return static_cast<std::int64_t>(m_hi) < 0; }
+    bool isZero() const { return !m_ovf && m_hi == 0 && m_lo == 0; }
+
+    Fixed64 operator-() const;
+    Fixed64 operator+(const Fixed64 &o) const;
+    Fixed64 operator-(const Fixed64 &o) const;
+    Fixed64 operator*(const Fixed64 &o) const;
+    Fixed64 operator/(const Fixed64 &o) const;
+    // 与 fmod 相同, 结果符号跟随被除数
+    Fixed64 rem(const Fixed64 &o) const;
+    // 乘以 2^bits, 右移向零截断
+    Fixed64 shifted(int bits) const;
+
+    bool operator==(const Fixed64 &o) const { return m_ovf == o.m_ovf && m_hi == o.m_hi && m_lo == o.m_lo; }
+    bool operator!=(const Fixed64 &o) const { return !(*this == o); }
+
+private:
+    std::uint64_t m_hi = 0;
+    std::uint64_t m_lo = 0;
+    bool m_ovf = false;
+};
+
+// 数值后端: CalculatorCore 的求值模板按这里的接口访问数值类型
+template <typename T>
+struct FloatBackend
+{
+    using Value = T;
+
+    static Value fromInt(long long v) { return static_cast<T>(v); }
+    static Value fromU64(std::uint64_t v) { return static_cast<T>(v); }
+    // v * 2^exp
+    static Value fromU64Exp(std::uint64_t v, int exp) { return std::ldexp(static_cast<T>(v), exp); }
+    static Value ldexp(Value v, int exp) { return std::ldexp(v, exp); }
+    static Value nan() { return std::numeric_limits<T>::quiet_NaN(); }
+    static Value inf() { return std::numeric_limits<T>::infinity(); }
+
+    // 仅当 v 恰好是 long long 范围内的整数时返回 true
+    static bool toInt(Value v, long long &out){
+        if (!(v >= static_cast<T>(std::numeric_limits<long long>::min())
+              && v < -static_cast<T>(std::numeric_limits<long long>::min()))) return false;
+        out = static_cast<long long>(v);
+        return static_cast<T>(out) == v;
+    }
+    static std::uint64_t toU64(Value v) { return static_cast<std::uint64_t>(v); }
+    // UINT64_MAX 转成 double 会进位成 2^64, 所以直接和 2^64 比较
+    static bool exceedsU64(Value v) { return v >= static_cast<T>(1ull << 63) * 2; }
+    static long double toLongDouble(Value v) { return static_cast<long double>(v); }
+
+    static bool isNaN(Value v) { return std::isnan(v); }
+    static bool isInf(Value v) { return std::isinf(v); }
+    static bool isZero(Value v) { return v == 0; }
+    static bool isNeg(Value v) { return v < 0; }
+
+    static Value fmod(Value a, Value b) { return std::fmod(a, b); }
+    static Value pow(Value a, Value b) { return std::pow(a, b); }
+};
+
+struct DoubleBackend : FloatBackend<double>
+{
+    static constexpr const char *name = "double";
+    static constexpr int fracDigits = 12;
+};
+
+struct LongDoubleBackend : FloatBackend<long double>
+{
+    static constexpr const char *name = "longdouble";
+    static constexpr int fracDigits = 12;
+};
+
+#ifdef HEXCALC_HAS_FLOAT128
+// 软件实现的四精度浮点, 113 位尾数
+struct Float128Backend : FloatBackend<__float128>
+{
+    static constexpr const char *name = "float128";
+    static constexpr int fracDigits = 28;
+
+    static Value fromU64Exp(std::uint64_t v, int exp) { return ldexpq(static_cast<Value>(v), exp); }
+    static Value ldexp(Value v, int exp) { return ldexpq(v, exp); }
+    static Value nan() { return nanq(""); }
+    static Value inf() { return HUGE_VALQ; }
+    static bool isNaN(Value v) { return isnanq(v); }
+    static bool isInf(Value v) { return isinfq(v); }
+    static Value fmod(Value a, Value b) { return fmodq(a, b); }
+    static Value pow(Value a, Value b) { return powq(a, b); }
+};
+#endif
+
+struct Fixed64Backend
+{
+    using Value = Fixed64;
+
+    static constexpr const char *name = "fixed64";
+    static constexpr int fracDigits = 16;
+
+    static Value fromInt(long long v) { return Fixed64::fromInt(v); }
+    static Value fromU64(std::uint64_t v){
+        if (v > static_cast<std::uint64_t>(std::numeric_limits<long long>::max())) return Fixed64::overflowed();
+        return Fixed64::fromInt(static_cast<long long>(v));
+    }
+    static Value fromU64Exp(std::uint64_t v, int exp) { return Fixed64::fromRaw(0, v).shifted(exp + 64); }
+    static Value ldexp(Value v, int exp) { return v.shifted(exp); }
+    // 定点数没有 NaN / Inf, 统一用溢出标记表示
+    static Value nan() { return Fixed64::overflowed(); }
+    static Value inf() { return Fixed64::overflowed(); }
+
+    static bool toInt(Value v, long long &out){
+        if (v.isOverflow() || v.lo() != 0) return false;
+        out = static_cast<long long>(v.hi());
+        return true;
+    }
+    static std::uint64_t toU64(Value v) { return v.hi(); }
+    static bool exceedsU64(Value) { return false; }
+    static long double toLongDouble(Value v) { return v.toLongDouble(); }
+
+    static bool isNaN(Value) { return false; }
+    static bool isInf(Value v) { return v.isOverflow(); }
+    static bool isZero(Value v) { return v.isZero(); }
+    static bool isNeg(Value v) { return v.isNegative(); }
+
+    static Value fmod(Value a, Value b) { return a.rem(b); }
+    static Value pow(Value a, Value b){
+        return Fixed64::fromLongDouble(std::pow(a.toLongDouble(), b.toLongDouble()));
+    }
+};
+
+#endif // NUMERICBACKEND_H
@@ -0,0 +1,258 @@
+#include "program.h"
+#include "bitops.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr std::int64_t kFactorials[] = {
+    1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800, 479001600,
+    6227020800ll, 87178291200ll, 1307674368000ll, 20922789888000ll, 355687428096000ll,
+    6402373705728000ll, 121645100408832000ll, 2432902008176640000ll
+};
+
+// 检查有符号溢出的运算, 溢出时返回 false, r 为回绕后的值 (不是未定义行为)
+inline bool checkedAdd(std::int64_t a, std::int64_t b, std::int64_t &r){
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(a, b, &r);
+#else
+    r = static_cast<std::int64_t>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+    return ((a ^ r) & (b ^ r)) >= 0;
+#endif
+}
+inline bool checkedSub(std::int64_t a, std::int64_t b, std::int64_t &r){
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_sub_overflow(a, b, &r);
+#else
+    r = static_cast<std::int64_t>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+    return ((a ^ b) & (a ^ r)) >= 0;
+#endif
+}
+inline bool checkedMul(std::int64_t a, std::int64_t b, std::int64_t &r){
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, &r);
+#else
+    r = static_cast<std::int64_t>(static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b));
+    if (a == 0 || b == 0) return true;
+    constexpr std::int64_t kMin = std::numeric_limits<std::int64_t>::min();
+    if ((a == -1 && b == kMin) || (b == -1 && a == kMin)) return false;
+    return r / b == a;
+#endif
+}
+
+inline std::uint64_t word(std::int64_t v){
+    return static_cast<std::uint64_t>(v);
+}
+
+// 整块交给 bitops 的 *Block 函数; int64_t 与 uint64_t 可以互相别名
+inline std::uint64_t *words(std::int64_t *p){
+    return reinterpret_cast<std::uint64_t *>(p);
+}
+inline const std::uint64_t *words(const std::int64_t *p){
+    return reinterpret_cast<const std::uint64_t *>(p);
+}
+
+// 计算器把位操作的结果当作无符号数, 最高位为 1 时不是同一个值
+inline bool fromWord(std::uint64_t w, std::int64_t &r){
+    r = static_cast<std::int64_t>(w);
+    return r >= 0;
+}
+
+bool checkedPow(std::int64_t base, std::int64_t exp, std::int64_t &r){
+    r = 1;
+    bool ok = true;
+    while (exp > 0){
+        if (exp & 1) ok &= checkedMul(r, base, r);
+        exp >>= 1;
+        // 最后一次平方用不到, 不能让它的溢出影响结果
+        if (exp > 0) ok &= checkedMul(base, base, base);
+    }
+    return ok;
+}
+
+} // namespace
+
+void Program::emit(Op op, std::uint32_t arg){
+    Insn insn;
+    insn.op = op;
+    std::memset(insn.reserved, 0, sizeof(insn.reserved));
+    insn.arg = arg;
+    code.push_back(insn);
+}
+
+ProgramView Program::view() const{
+    ProgramView v;
+    v.code = code.data();
+    v.codeSize = code.size();
+    v.consts = consts.data();
+    v.constCount = consts.size();
+    v.varCount = vars.size();
+    v.maxDepth = maxDepth;
+    return v;
+}
+
+void Program::run(const std::int64_t *const *varValues, std::size_t n,
+                  std::int64_t *out, std::uint8_t *valid, std::int64_t *stack) const{
+    view().run(varValues, n, out, valid, stack);
+}
+
+bool ProgramView::verify() const{
+    using Op = Program::Op;
+    std::size_t depth = 0;
+    for (std::size_t pc = 0; pc < codeSize; pc++){
+        const Program::Insn &insn = code[pc];
+        if (insn.op == Op::Const || insn.op == Op::Var){
+            if (insn.arg >= (insn.op == Op::Const ? constCount : varCount)) return false;
+            depth++;
+        } else if (insn.op == Op::Not || insn.op == Op::Fact || (insn.op >= Op::Popcnt && insn.op <= Op::Parity)){
+            if (depth < 1) return false;
+        } else if (insn.op <= Op::Pdep){
+            if (depth < 2) return false;
+            depth--;
+        } else {
+            return false;
+        }
+        if (depth > maxDepth) return false;
+    }
+    return depth == 1;
+}
+
+void ProgramView::run(const std::int64_t *const *varValues, std::size_t n,
+                      std::int64_t *out, std::uint8_t *valid, std::int64_t *stack) const{
+    using Op = Program::Op;
+    constexpr std::size_t kBlock = Program::kBlock;
+    std::fill(valid, valid + n, std::uint8_t(1));
+    std::size_t sp = 0;
+
+    for (std::size_t pc = 0; pc < codeSize; pc++){
+        const Program::Insn &insn = code[pc];
+        if (insn.op == Op::Const || insn.op == Op::Var){
+            std::int64_t *d = stack + sp * kBlock;
+            if (insn.op == Op::Const) std::fill(d, d + n, consts[insn.arg]);
+            else std::memcpy(d, varValues[insn.arg], n * sizeof(std::int64_t));
+            sp++;
+            continue;
+        }
+
+        std::int64_t *a = stack + (sp - 1) * kBlock;
+        switch (insn.op){
+        case Op::Not:
+            for (std::size_t i = 0; i < n; i++) a[i] = ~a[i];
+            continue;
+        case Op::Fact:
+            for (std::size_t i = 0; i < n; i++){
+                const bool ok = a[i] >= 0 && a[i] <= 20;
+                valid[i] &= ok;
+                a[i] = ok ? kFactorials[a[i]] : 0;
+            }
+            continue;
+        case Op::Popcnt:
+            bitPopcountBlock(words(a), words(a), n);
+            continue;
+        case Op::Clz:
+            bitClzBlock(words(a), words(a), n);
+            continue;
+        case Op::Ctz:
+            bitCtzBlock(words(a), words(a), n);
+            continue;
+        case Op::Parity:
+            bitParityBlock(words(a), words(a), n);
+            continue;
+        case Op::Bswap:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= fromWord(bitBswap(word(a[i])), a[i]);
+            continue;
+        case Op::Bitrev:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= fromWord(bitReverse(word(a[i])), a[i]);
+            continue;
+        default:
+            break;
+        }
+
+        // 二元运算: a = stack[sp - 2] op stack[sp - 1]
+        const std::int64_t *b = a;
+        a -= kBlock;
+        sp--;
+
+        switch (insn.op){
+        case Op::Add:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= checkedAdd(a[i], b[i], a[i]);
+            break;
+        case Op::Sub:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= checkedSub(a[i], b[i], a[i]);
+            break;
+        case Op::Mul:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= checkedMul(a[i], b[i], a[i]);
+            break;
+        case Op::And:
+            for (std::size_t i = 0; i < n; i++) a[i] &= b[i];
+            break;
+        case Op::Or:
+            for (std::size_t i = 0; i < n; i++) a[i] |= b[i];
+            break;
+        case Op::Xor:
+            for (std::size_t i = 0; i < n; i++) a[i] ^= b[i];
+            break;
+        case Op::Shl:
+            for (std::size_t i = 0; i < n; i++){
+                // 与计算器相同, 按 64 位字移位后回绕
+                valid[i] &= static_cast<std::uint64_t>(b[i]) <= 63;
+                a[i] = static_cast<std::int64_t>(word(a[i]) << (b[i] & 63));
+            }
+            break;
+        case Op::Shr:
+            for (std::size_t i = 0; i < n; i++){
+                const bool ok = static_cast<std::uint64_t>(b[i]) <= 63;
+                valid[i] &= ok;
+                a[i] >>= (b[i] & 63);
+            }
+            break;
+        case Op::Rol:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= fromWord(bitRol(word(a[i]), static_cast<unsigned>(b[i])), a[i]);
+            break;
+        case Op::Ror:
+            for (std::size_t i = 0; i < n; i++) valid[i] &= fromWord(bitRor(word(a[i]), static_cast<unsigned>(b[i])), a[i]);
+            break;
+        case Op::Pext:
+            bitPextBlock(words(a), words(b), words(a), n);
+            for (std::size_t i = 0; i < n; i++) valid[i] &= a[i] >= 0;
+            break;
+        case Op::Pdep:
+            bitPdepBlock(words(a), words(b), words(a), n);
+            for (std::size_t i = 0; i < n; i++) valid[i] &= a[i] >= 0;
+            break;
+        case Op::Div:
+            for (std::size_t i = 0; i < n; i++){
+                // 除不尽时计算器的结果是小数; INT64_MIN / -1 溢出
+                const bool ok = b[i] != 0 && !(b[i] == -1 && a[i] == std::numeric_limits<std::int64_t>::min())
+                                && a[i] % b[i] == 0;
+                valid[i] &= ok;
+                a[i] = ok ? a[i] / b[i] : 0;
+            }
+            break;
+        case Op::Mod:
+            for (std::size_t i = 0; i < n; i++){
+                const bool zero = b[i] == 0;
+                valid[i] &= !zero;
+                a[i] = zero || b[i] == -1 ? 0 : a[i] % b[i];
+            }
+            break;
+        case Op::Pow:
+            for (std::size_t i = 0; i < n; i++){
+                // 负指数只有底数为 1 / -1 时才是整数
+                if (b[i] >= 0) valid[i] &= checkedPow(a[i], b[i], a[i]);
+                else if (a[i] == 1) a[i] = 1;
+                else if (a[i] == -1) a[i] = (b[i] & 1) ? -1 : 1;
+                else {
+                    valid[i] = 0;
+                    a[i] = 0;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::memcpy(out, stack, n * sizeof(std::int64_t));
+}
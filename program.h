@@ -0,0 +1,88 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ProgramView;
+
+// 编译后的表达式: 扁平的栈机指令 + 常量池, 按 64 位有符号整数求值
+// 有效通道的结果与 HexEngine::compute() 相同, 不同的情况都把通道标记为无效, 不报错:
+//   + - * ^ 有符号溢出, / 除不尽 (计算器结果为小数), 除零, 移位越界, 阶乘溢出
+//   位操作 (BSWAP / ROL / PEXT ...) 的结果按无符号字解释, 最高位为 1 时超出范围
+// % 向零截断, << 按 64 位回绕, >> 为算术右移, 循环移位的位数按 64 取模
+// 常量必须在 0..7FFFFFFFFFFFFFFF 之间, 更大的常量计算器按无符号数处理, 编译时拒绝
+class Program
+{
+public:
+    enum class Op : std::uint8_t {
+        Const,      // arg: 常量池下标
+        Var,        // arg: 变量下标
+        Not,
+        Fact,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Mod,
+        Pow,
+        And,
+        Or,
+        Xor,
+        Shl,
+        Shr,
+        Popcnt,
+        Clz,
+        Ctz,
+        Bswap,
+        Bitrev,
+        Parity,
+        Rol,
+        Ror,
+        Pext,
+        Pdep
+    };
+
+    struct Insn {
+        Op op;
+        std::uint8_t reserved[3];
+        std::uint32_t arg;
+    };
+
+    // 一次求值的通道数, 每条指令在整个块上循环, 便于编译器向量化
+    static constexpr std::size_t kBlock = 256;
+
+    std::vector<Insn> code;
+    std::vector<std::int64_t> consts;
+    std::vector<std::string> vars;      // 按首次出现的顺序
+    std::uint32_t maxDepth = 0;
+
+    void emit(Op op, std::uint32_t arg = 0);
+    ProgramView view() const;
+
+    // 对 n (<= kBlock) 个通道求值, vars[v] 指向第 v 个变量的 n 个取值
+    // 结果写入 out, 无效的通道 valid[i] 为 0; stack 至少 maxDepth * kBlock 个元素
+    void run(const std::int64_t *const *varValues, std::size_t n,
+             std::int64_t *out, std::uint8_t *valid, std::int64_t *stack) const;
+};
+
+// 不持有数据的程序, 指向 Program 的成员或映射进来的程序库 (ProgramLibrary)
+struct ProgramView
+{
+    const Program::Insn *code = nullptr;
+    std::size_t codeSize = 0;
+    const std::int64_t *consts = nullptr;
+    std::size_t constCount = 0;
+    std::size_t varCount = 0;
+    std::uint32_t maxDepth = 0;
+
+    // 与 Program::run() 相同
+    void run(const std::int64_t *const *varValues, std::size_t n,
+             std::int64_t *out, std::uint8_t *valid, std::int64_t *stack) const;
+    // 检查操作码 / 常量和变量下标 / 栈深度, 来自不可信文件的程序在 run() 之前调用
+    bool verify() const;
+};
+
+#endif // PROGRAM_H
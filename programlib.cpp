@@ -0,0 +1,275 @@
+#include "programlib.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+constexpr char kMagic[8] = { 'H', 'E', 'X', 'C', 'P', 'L', 'I', 'B' };
+// 按本机字节序写入, 读出来不同说明字节序不同
+constexpr std::uint32_t kByteOrder = 0x01020304;
+
+struct Section {
+    std::uint64_t offset;
+    std::uint64_t size;     // 字节数
+};
+
+std::uint64_t align16(std::uint64_t v){
+    return (v + 15) & ~std::uint64_t(15);
+}
+
+bool inRange(std::uint32_t start, std::uint32_t count, std::size_t total){
+    return static_cast<std::uint64_t>(start) + count <= total;
+}
+
+} // namespace
+
+struct ProgramLibrary::Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t insnSize;
+    std::uint32_t entrySize;
+    std::uint32_t count;
+    std::uint32_t reserved;
+    Section index;
+    Section code;
+    Section consts;
+    Section vars;
+    Section strings;
+};
+
+// 各字段都是对应段中的元素下标 / 个数
+struct ProgramLibrary::Entry {
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t codeIndex;
+    std::uint32_t codeCount;
+    std::uint32_t constIndex;
+    std::uint32_t constCount;
+    std::uint32_t varIndex;
+    std::uint32_t varCount;
+    std::uint32_t maxDepth;
+    std::uint32_t reserved;
+};
+
+struct ProgramLibrary::StringRef {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+static_assert(sizeof(Program::Insn) == 8, "Program::Insn is stored as is");
+
+bool ProgramLibrary::write(const std::string &path, const std::vector<std::pair<std::string, Program>> &programs,
+                           HexErrorCode &err){
+    static_assert(sizeof(Header) == 112 && sizeof(Entry) == 40 && sizeof(StringRef) == 8, "file layout changed");
+
+    // 按名字排序, 加载时二分查找
+    std::vector<std::size_t> order(programs.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(), [&programs](std::size_t a, std::size_t b){
+        return programs[a].first < programs[b].first;
+    });
+    for (std::size_t i = 1; i < order.size(); i++){
+        if (programs[order[i - 1]].first == programs[order[i]].first){
+            err = HexErrorCode::DuplicateProgramName;
+            return false;
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::vector<Program::Insn> code;
+    std::vector<std::int64_t> consts;
+    std::vector<StringRef> vars;
+    std::string strings;
+    entries.reserve(programs.size());
+
+    auto addString = [&strings](const std::string &s){
+        const StringRef r { static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(s.size()) };
+        strings += s;
+        return r;
+    };
+
+    for (const std::size_t i : order){
+        const std::string &name = programs[i].first;
+        const Program &p = programs[i].second;
+
+        Entry e {};
+        const StringRef n = addString(name);
+        e.nameOffset = n.offset;
+        e.nameLength = n.length;
+        e.codeIndex = static_cast<std::uint32_t>(code.size());
+        e.codeCount = static_cast<std::uint32_t>(p.code.size());
+        e.constIndex = static_cast<std::uint32_t>(consts.size());
+        e.constCount = static_cast<std::uint32_t>(p.consts.size());
+        e.varIndex = static_cast<std::uint32_t>(vars.size());
+        e.varCount = static_cast<std::uint32_t>(p.vars.size());
+        e.maxDepth = p.maxDepth;
+        entries.push_back(e);
+
+        code.insert(code.end(), p.code.begin(), p.code.end());
+        consts.insert(consts.end(), p.consts.begin(), p.consts.end());
+        for (const std::string &v : p.vars) vars.push_back(addString(v));
+    }
+
+    // 下标都是 32 位
+    constexpr std::size_t kLimit = std::numeric_limits<std::uint32_t>::max();
+    if (code.size() > kLimit || consts.size() > kLimit || vars.size() > kLimit || strings.size() > kLimit){
+        err = HexErrorCode::WriteFailed;
+        return false;
+    }
+
+    Header h {};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.byteOrder = kByteOrder;
+    h.insnSize = sizeof(Program::Insn);
+    h.entrySize = sizeof(Entry);
+    h.count = static_cast<std::uint32_t>(entries.size());
+
+    std::uint64_t pos = align16(sizeof(Header));
+    auto place = [&pos](std::uint64_t bytes){
+        const Section s { pos, bytes };
+        pos = align16(pos + bytes);
+        return s;
+    };
+    h.index = place(entries.size() * sizeof(Entry));
+    h.code = place(code.size() * sizeof(Program::Insn));
+    h.consts = place(consts.size() * sizeof(std::int64_t));
+    h.vars = place(vars.size() * sizeof(StringRef));
+    h.strings = place(strings.size());
+
+    std::vector<char> buf(static_cast<std::size_t>(pos), 0);
+    auto put = [&buf](const Section &s, const void *data){
+        if (s.size) std::memcpy(buf.data() + s.offset, data, static_cast<std::size_t>(s.size));
+    };
+    std::memcpy(buf.data(), &h, sizeof(h));
+    put(h.index, entries.data());
+    put(h.code, code.data());
+    put(h.consts, consts.data());
+    put(h.vars, vars.data());
+    put(h.strings, strings.data());
+
+    // 先写临时文件再改名, 写到一半失败时不会留下被别人映射的残缺文件
+    const std::string tmpPath = path + ".tmp";
+    std::FILE *f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f){
+        err = HexErrorCode::FileOpenFailed;
+        return false;
+    }
+    bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    ok = std::fclose(f) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, path, ec);
+    if (!ok || ec){
+        std::filesystem::remove(tmpPath, ec);
+        err = HexErrorCode::WriteFailed;
+        return false;
+    }
+    return true;
+}
+
+bool ProgramLibrary::open(const std::string &path, HexErrorCode &err){
+    close();
+    if (!m_file.open(path, err)) return false;
+
+    auto reject = [this, &err](HexErrorCode code){
+        close();
+        err = code;
+        return false;
+    };
+
+    const std::uint8_t *base = m_file.data();
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(m_file.size());
+    if (fileSize < sizeof(Header)) return reject(HexErrorCode::InvalidLibrary);
+
+    Header h;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.byteOrder != kByteOrder) return reject(HexErrorCode::InvalidLibrary);
+    if (h.version != kVersion) return reject(HexErrorCode::UnsupportedLibraryVersion);
+    if (h.insnSize != sizeof(Program::Insn) || h.entrySize != sizeof(Entry)) return reject(HexErrorCode::InvalidLibrary);
+
+    // 只检查段的位置和对齐, 条目在访问时再检查, 打开的耗时与程序个数无关
+    auto valid = [fileSize](const Section &s, std::size_t elemSize){
+        return s.offset % 16 == 0 && s.offset <= fileSize && s.size <= fileSize - s.offset && s.size % elemSize == 0;
+    };
+    if (!valid(h.index, sizeof(Entry)) || !valid(h.code, sizeof(Program::Insn)) || !valid(h.consts, sizeof(std::int64_t))
+        || !valid(h.vars, sizeof(StringRef)) || !valid(h.strings, 1) || h.index.size / sizeof(Entry) != h.count){
+        return reject(HexErrorCode::InvalidLibrary);
+    }
+
+    // 映射的起始地址按页对齐, 段按 16 字节对齐, 可以直接当数组访问
+    m_entries = reinterpret_cast<const Entry *>(base + h.index.offset);
+    m_count = h.count;
+    m_code = reinterpret_cast<const Program::Insn *>(base + h.code.offset);
+    m_codeSize = static_cast<std::size_t>(h.code.size / sizeof(Program::Insn));
+    m_consts = reinterpret_cast<const std::int64_t *>(base + h.consts.offset);
+    m_constCount = static_cast<std::size_t>(h.consts.size / sizeof(std::int64_t));
+    m_vars = reinterpret_cast<const StringRef *>(base + h.vars.offset);
+    m_varCount = static_cast<std::size_t>(h.vars.size / sizeof(StringRef));
+    m_strings = reinterpret_cast<const char *>(base + h.strings.offset);
+    m_stringSize = static_cast<std::size_t>(h.strings.size);
+    return true;
+}
+
+void ProgramLibrary::close(){
+    m_file.close();
+    m_entries = nullptr;
+    m_count = 0;
+    m_code = nullptr;
+    m_codeSize = 0;
+    m_consts = nullptr;
+    m_constCount = 0;
+    m_vars = nullptr;
+    m_varCount = 0;
+    m_strings = nullptr;
+    m_stringSize = 0;
+}
+
+std::string_view ProgramLibrary::name(std::size_t i) const{
+    if (i >= m_count) return std::string_view();
+    const Entry &e = m_entries[i];
+    if (!inRange(e.nameOffset, e.nameLength, m_stringSize)) return std::string_view();
+    return std::string_view(m_strings + e.nameOffset, e.nameLength);
+}
+
+bool ProgramLibrary::at(std::size_t i, ProgramView &out) const{
+    if (i >= m_count) return false;
+    const Entry &e = m_entries[i];
+    if (!inRange(e.codeIndex, e.codeCount, m_codeSize) || !inRange(e.constIndex, e.constCount, m_constCount)
+        || !inRange(e.varIndex, e.varCount, m_varCount)) return false;
+
+    out.code = m_code + e.codeIndex;
+    out.codeSize = e.codeCount;
+    out.consts = m_consts + e.constIndex;
+    out.constCount = e.constCount;
+    out.varCount = e.varCount;
+    out.maxDepth = e.maxDepth;
+    return true;
+}
+
+bool ProgramLibrary::find(std::string_view name, ProgramView &out) const{
+    std::size_t lo = 0;
+    std::size_t hi = m_count;
+    while (lo < hi){
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const int c = this->name(mid).compare(name);
+        if (c == 0) return at(mid, out);
+        if (c < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return false;
+}
+
+std::string_view ProgramLibrary::varName(std::size_t i, std::size_t v) const{
+    if (i >= m_count) return std::string_view();
+    const Entry &e = m_entries[i];
+    if (v >= e.varCount || static_cast<std::uint64_t>(e.varIndex) + v >= m_varCount) return std::string_view();
+    const StringRef &r = m_vars[e.varIndex + v];
+    if (!inRange(r.offset, r.length, m_stringSize)) return std::string_view();
+    return std::string_view(m_strings + r.offset, r.length);
+}
@@ -0,0 +1,63 @@
+#ifndef PROGRAMLIB_H
+#define PROGRAMLIB_H
+
+#include "hexerror.h"
+#include "mappedfile.h"
+#include "program.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// 编译好的程序库文件: 固定的文件头 + 几个按 16 字节对齐的段, 只用偏移互相引用, 与加载地址无关
+//   索引段   按名字排序的条目: 名字 / 指令 / 常量 / 变量在各段中的范围, 最大栈深度
+//   指令段   所有程序的 Program::Insn
+//   常量段   所有程序的常量池
+//   变量段   变量名在字符串段中的位置
+//   字符串段 程序名和变量名, 不以 0 结尾
+// 数值按本机字节序存放, 字节序不同的文件拒绝加载
+// 加载只做内存映射和文件头检查, 不解析, 也不为单个程序分配内存, 耗时与库的大小无关
+// 只能保存 HexEngine::compile() 的结果, 即 64 位整数表达式; 小数常量 / 字节数组 / MOD 无法放入库中
+class ProgramLibrary
+{
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    // 名字不能重复; 先写 path.tmp 再改名, 失败时原有的 path 不变
+    // 失败时 err 为 DuplicateProgramName / FileOpenFailed / WriteFailed
+    static bool write(const std::string &path, const std::vector<std::pair<std::string, Program>> &programs,
+                      HexErrorCode &err);
+
+    // 失败时 err 为 FileOpenFailed / FileMapFailed / InvalidLibrary / UnsupportedLibraryVersion
+    bool open(const std::string &path, HexErrorCode &err);
+    void close();
+
+    std::size_t size() const { return m_count; }
+    std::string_view name(std::size_t i) const;
+    // 条目指向文件之外时返回 false; 文件不可信时再对结果调用 ProgramView::verify()
+    bool at(std::size_t i, ProgramView &out) const;
+    // 按名字二分查找
+    bool find(std::string_view name, ProgramView &out) const;
+    std::string_view varName(std::size_t i, std::size_t v) const;
+
+private:
+    struct Header;
+    struct Entry;
+    struct StringRef;
+
+    MappedFile m_file;
+    const Entry *m_entries = nullptr;
+    std::size_t m_count = 0;
+    const Program::Insn *m_code = nullptr;
+    std::size_t m_codeSize = 0;
+    const std::int64_t *m_consts = nullptr;
+    std::size_t m_constCount = 0;
+    const StringRef *m_vars = nullptr;
+    std::size_t m_varCount = 0;
+    const char *m_strings = nullptr;
+    std::size_t m_stringSize = 0;
+};
+
+#endif // PROGRAMLIB_H
@@ -0,0 +1,72 @@
+#include "sessionlog.h"
+
+bool SessionLog::start(const QString &path, QString &err){
+    stop();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)){
+        err = QString("cannot open '%1' for writing").arg(path);
+        return false;
+    }
+    return true;
+}
+
+void SessionLog::stop(){
+    if (m_file.isOpen()) m_file.close();
+}
+
+void SessionLog::recordEdit(const QString &text, int cursor){
+    writeLine("edit " + QByteArray::number(cursor) + ' ' + text.toUtf8().toPercentEncoding());
+}
+
+void SessionLog::recordClick(const QString &objectName){
+    writeLine("click " + objectName.toUtf8());
+}
+
+void SessionLog::recordReturn(){
+    writeLine("return");
+}
+
+void SessionLog::writeLine(const QByteArray &line){
+    if (!m_file.isOpen()) return;
+    m_file.write(line + '\n');
+    m_file.flush();
+}
+
+bool SessionLog::load(const QString &path, QVector<Event> &out, QString &err){
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)){
+        err = QString("cannot open '%1'").arg(path);
+        return false;
+    }
+
+    out.clear();
+    int lineNo = 0;
+    while (!file.atEnd()){
+        const QByteArray line = file.readLine().trimmed();
+        lineNo++;
+        if (line.isEmpty()) continue;
+
+        const QList<QByteArray> parts = line.split(' ');
+        Event e;
+        if (parts[0] == "edit" && parts.size() >= 2){
+            bool ok = false;
+            e.type = Event::Type::Edit;
+            e.cursor = parts[1].toInt(&ok);
+            e.text = parts.size() >= 3 ? QString::fromUtf8(QByteArray::fromPercentEncoding(parts[2])) : QString();
+            if (!ok){
+                err = QString("%1:%2: invalid cursor").arg(path).arg(lineNo);
+                return false;
+            }
+        } else if (parts[0] == "click" && parts.size() == 2){
+            e.type = Event::Type::Click;
+            e.text = QString::fromUtf8(parts[1]);
+        } else if (parts[0] == "return"){
+            e.type = Event::Type::Return;
+        } else {
+            err = QString("%1:%2: unknown event").arg(path).arg(lineNo);
+            return false;
+        }
+        out.push_back(e);
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// 按键会话的录制与读取, 每行一个事件:
+//   edit <cursor> <percent-encoded text>
+//   click <button objectName>
+//   return
+class SessionLog
+{
+public:
+    struct Event {
+        enum class Type {
+            Edit,
+            Click,
+            Return
+        };
+        Type type;
+        QString text;
+        int cursor = 0;
+    };
+
+    bool start(const QString &path, QString &err);
+    void stop();
+    bool isRecording() const { return m_file.isOpen(); }
+
+    void recordEdit(const QString &text, int cursor);
+    void recordClick(const QString &objectName);
+    void recordReturn();
+
+    static bool load(const QString &path, QVector<Event> &out, QString &err);
+
+private:
+    void writeLine(const QByteArray &line);
+
+    QFile m_file;
+};
+
+#endif // SESSIONLOG_H
@@ -0,0 +1,263 @@
+#include "solver.h"
+#include "hexscan.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// 每次从共享计数器领取的候选数, 是 Program::kBlock 的整数倍
+constexpr std::uint64_t kChunk = Program::kBlock * 256;
+
+bool parseHexInt(std::string_view s, std::int64_t &out){
+    bool neg = false;
+    if (!s.empty() && (s.front() == '-' || s.front() == '+')){
+        neg = s.front() == '-';
+        s.remove_prefix(1);
+    }
+    while (s.size() > 1 && s.front() == '0') s.remove_prefix(1);
+    if (s.empty() || s.size() > 16) return false;
+
+    std::string upper(s);
+    for (char &c : upper){
+        if (c >= 'a' && c <= 'f') c = static_cast<char>(c - 'a' + 'A');
+    }
+    std::uint64_t w = 0;
+    if (!hexToWord(upper.data(), upper.size(), w)) return false;
+    out = static_cast<std::int64_t>(neg ? 0 - w : w);
+    return true;
+}
+
+std::string_view trimmed(std::string_view s){
+    while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+    while (!s.empty() && s.back() == ' ') s.remove_suffix(1);
+    return s;
+}
+
+bool matches(Solver::Compare compare, std::int64_t v, std::int64_t target){
+    switch (compare){
+    case Solver::Compare::Eq: return v == target;
+    case Solver::Compare::Ne: return v != target;
+    case Solver::Compare::Lt: return v < target;
+    case Solver::Compare::Le: return v <= target;
+    case Solver::Compare::Gt: return v > target;
+    case Solver::Compare::Ge: return v >= target;
+    }
+    return false;
+}
+
+} // namespace
+
+bool Solver::parseTarget(std::string_view spec, Compare &compare, std::int64_t &target, std::string &err){
+    spec = trimmed(spec);
+    static const struct { const char *prefix; Compare compare; } prefixes[] = {
+        { "!=", Compare::Ne }, { "<=", Compare::Le }, { ">=", Compare::Ge },
+        { "=", Compare::Eq }, { "<", Compare::Lt }, { ">", Compare::Gt }
+    };
+
+    compare = Compare::Eq;
+    for (const auto &p : prefixes){
+        const std::string_view prefix(p.prefix);
+        if (spec.substr(0, prefix.size()) == prefix){
+            compare = p.compare;
+            spec.remove_prefix(prefix.size());
+            break;
+        }
+    }
+
+    if (!parseHexInt(trimmed(spec), target)){
+        err = "invalid target '" + std::string(spec) + "'";
+        return false;
+    }
+    return true;
+}
+
+bool Solver::parseRange(std::string_view spec, std::string &name, Range &range, std::string &err){
+    const std::size_t eq = spec.find('=');
+    const std::size_t dots = spec.find("..");
+    if (eq == std::string_view::npos || dots == std::string_view::npos || dots < eq
+        || !parseHexInt(trimmed(spec.substr(eq + 1, dots - eq - 1)), range.lo)
+        || !parseHexInt(trimmed(spec.substr(dots + 2)), range.hi)){
+        err = "invalid range '" + std::string(spec) + "', expected NAME=LO..HI";
+        return false;
+    }
+
+    name = std::string(trimmed(spec.substr(0, eq)));
+    for (char &c : name){
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    }
+    if (range.hi < range.lo){
+        err = "empty range for '" + name + "'";
+        return false;
+    }
+    return true;
+}
+
+bool Solver::solve(const Program &program, const Options &options,
+                   std::vector<std::int64_t> &solutions, std::string &err){
+    for (std::size_t v = 0; v < program.vars.size() && v < options.ranges.size(); v++){
+        if (options.ranges[v].hi < options.ranges[v].lo){
+            solutions.clear();
+            err = "empty range for '" + program.vars[v] + "'";
+            return false;
+        }
+    }
+    return solve(program.view(), options, solutions, err);
+}
+
+bool Solver::solve(const ProgramView &program, const Options &options,
+                   std::vector<std::int64_t> &solutions, std::string &err){
+    solutions.clear();
+    const std::size_t varCount = program.varCount;
+    if (varCount == 0){
+        err = "expression has no variables to solve for";
+        return false;
+    }
+    if (options.ranges.size() != varCount){
+        err = "every variable needs a range";
+        return false;
+    }
+
+    // 搜索空间大小, 不能超过 2^64 - 1
+    std::vector<std::uint64_t> sizes(varCount);
+    std::uint64_t total = 1;
+    for (std::size_t v = 0; v < varCount; v++){
+        const Range &r = options.ranges[v];
+        if (r.hi < r.lo){
+            err = "empty range for variable " + std::to_string(v + 1);
+            return false;
+        }
+        sizes[v] = static_cast<std::uint64_t>(r.hi) - static_cast<std::uint64_t>(r.lo) + 1;
+        if (sizes[v] == 0 || total > std::numeric_limits<std::uint64_t>::max() / sizes[v]){
+            err = "search space too large";
+            return false;
+        }
+        total *= sizes[v];
+    }
+
+    const std::uint64_t chunkCount = (total - 1) / kChunk + 1;
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::max<std::uint64_t>(1, std::min<std::uint64_t>(std::max(threads, 1u), chunkCount)));
+
+    std::atomic<std::uint64_t> nextChunk{0};
+    std::atomic<std::uint64_t> scanned{0};
+    std::atomic<std::uint64_t> found{0};
+    // 已经凑够 limit 个解时, 只需要继续搜索下标不超过 cutoff 的部分
+    std::atomic<std::uint64_t> cutoff{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<bool> cancelled{false};
+    std::mutex mutex;
+    std::condition_variable done;
+    unsigned running = threads;
+    std::vector<std::uint64_t> hits;
+
+    auto worker = [&](){
+        const std::size_t depth = std::max<std::size_t>(program.maxDepth, 1);
+        std::vector<std::int64_t> stack(depth * Program::kBlock);
+        std::vector<std::int64_t> out(Program::kBlock);
+        std::vector<std::uint8_t> valid(Program::kBlock);
+        std::vector<std::int64_t> values(varCount * Program::kBlock);
+        std::vector<const std::int64_t *> varValues(varCount);
+        std::vector<std::uint64_t> digits(varCount);
+        std::vector<std::uint64_t> local;
+        for (std::size_t v = 0; v < varCount; v++) varValues[v] = values.data() + v * Program::kBlock;
+
+        for (;;){
+            const std::uint64_t c = nextChunk.fetch_add(1);
+            if (c >= chunkCount || cancelled.load(std::memory_order_relaxed)) break;
+            const std::uint64_t begin = c * kChunk;
+            if (begin > cutoff.load(std::memory_order_relaxed)) break;
+            const std::uint64_t end = begin + std::min(kChunk, total - begin);
+
+            for (std::uint64_t block = begin; block < end; block += Program::kBlock){
+                const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(Program::kBlock, end - block));
+
+                // 下标按混合进制拆成各变量的偏移
+                std::uint64_t idx = block;
+                for (std::size_t v = varCount; v-- > 0;){
+                    digits[v] = idx % sizes[v];
+                    idx /= sizes[v];
+                }
+                // 最后一个变量在块内连续递增, 其余变量只在它进位时才变化
+                const std::size_t last = varCount - 1;
+                for (std::size_t i = 0; i < n;){
+                    const std::size_t run = static_cast<std::size_t>(std::min<std::uint64_t>(n - i, sizes[last] - digits[last]));
+                    const std::uint64_t first = static_cast<std::uint64_t>(options.ranges[last].lo) + digits[last];
+                    std::int64_t *lastValues = values.data() + last * Program::kBlock + i;
+                    for (std::size_t k = 0; k < run; k++) lastValues[k] = static_cast<std::int64_t>(first + k);
+                    for (std::size_t v = 0; v < last; v++){
+                        std::int64_t *d = values.data() + v * Program::kBlock + i;
+                        std::fill(d, d + run, static_cast<std::int64_t>(static_cast<std::uint64_t>(options.ranges[v].lo) + digits[v]));
+                    }
+
+                    i += run;
+                    digits[last] += run;
+                    for (std::size_t v = varCount; v-- > 0 && digits[v] == sizes[v];){
+                        digits[v] = 0;
+                        if (v > 0) digits[v - 1]++;
+                    }
+                }
+
+                program.run(varValues.data(), n, out.data(), valid.data(), stack.data());
+                for (std::size_t i = 0; i < n; i++){
+                    if (valid[i] && matches(options.compare, out[i], options.target)) local.push_back(block + i);
+                }
+            }
+            scanned.fetch_add(end - begin, std::memory_order_relaxed);
+
+            if (!local.empty()){
+                std::lock_guard<std::mutex> lock(mutex);
+                hits.insert(hits.end(), local.begin(), local.end());
+                local.clear();
+                if (options.limit && hits.size() >= options.limit){
+                    const auto nth = hits.begin() + static_cast<std::ptrdiff_t>(options.limit - 1);
+                    std::nth_element(hits.begin(), nth, hits.end());
+                    hits.resize(static_cast<std::size_t>(options.limit));
+                    cutoff.store(*std::max_element(hits.begin(), hits.end()));
+                }
+                found.store(hits.size(), std::memory_order_relaxed);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        done.notify_all();
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; t++) pool.emplace_back(worker);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!done.wait_for(lock, std::chrono::milliseconds(100), [&running](){ return running == 0; })){
+            if (!options.progress) continue;
+            lock.unlock();
+            if (!options.progress(scanned.load(), total, found.load())) cancelled.store(true);
+            lock.lock();
+        }
+    }
+    for (std::thread &t : pool) t.join();
+
+    if (cancelled.load()){
+        err = "search cancelled";
+        return false;
+    }
+    if (options.progress) options.progress(scanned.load(), total, hits.size());
+
+    std::sort(hits.begin(), hits.end());
+    if (options.limit && hits.size() > options.limit) hits.resize(static_cast<std::size_t>(options.limit));
+
+    solutions.resize(hits.size() * varCount);
+    for (std::size_t h = 0; h < hits.size(); h++){
+        std::uint64_t idx = hits[h];
+        for (std::size_t v = varCount; v-- > 0;){
+            solutions[h * varCount + v] = static_cast<std::int64_t>(static_cast<std::uint64_t>(options.ranges[v].lo) + idx % sizes[v]);
+            idx /= sizes[v];
+        }
+    }
+    return true;
+}
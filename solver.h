@@ -0,0 +1,54 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "program.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 在变量取值范围的笛卡尔积上穷举, 找出使表达式满足条件的输入
+// 搜索空间按块分给所有核心并行求值, 结果按搜索顺序 (最后一个变量变化最快) 排列
+class Solver
+{
+public:
+    enum class Compare {
+        Eq,
+        Ne,
+        Lt,
+        Le,
+        Gt,
+        Ge
+    };
+
+    // 闭区间 [lo, hi]
+    struct Range {
+        std::int64_t lo;
+        std::int64_t hi;
+    };
+
+    struct Options {
+        Compare compare = Compare::Eq;
+        std::int64_t target = 0;
+        std::vector<Range> ranges;      // 与程序的变量一一对应
+        std::uint64_t limit = 0;        // 0 表示找出全部
+        unsigned threads = 0;           // 0 表示按核心数
+        // 在调用 solve() 的线程上大约每 100ms 回调一次, 返回 false 取消搜索
+        std::function<bool(std::uint64_t scanned, std::uint64_t total, std::uint64_t found)> progress;
+    };
+
+    // 每个解占 varCount 个连续元素
+    static bool solve(const ProgramView &program, const Options &options,
+                      std::vector<std::int64_t> &solutions, std::string &err);
+    // 同上, 出错信息带变量名
+    static bool solve(const Program &program, const Options &options,
+                      std::vector<std::int64_t> &solutions, std::string &err);
+
+    // "=1234" / "!=0" / "<10" / ">=FF" 等, 不带比较符时为相等
+    static bool parseTarget(std::string_view spec, Compare &compare, std::int64_t &target, std::string &err);
+    // "X=0..FFFF", 返回变量名
+    static bool parseRange(std::string_view spec, std::string &name, Range &range, std::string &err);
+};
+
+#endif // SOLVER_H
@@ -0,0 +1,382 @@
+#include "streamparser.h"
+#include "hexengine.h"
+#include "hexscan.h"
+#include "hexsyntax.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// 单字符运算符, 入栈时 text 指向这里
+constexpr std::string_view kSingleOps = "+-*/%&|";
+
+bool isParen(const StreamParser::Item &t){
+    return t.text == "(";
+}
+
+} // namespace
+
+StreamParser::StreamParser(Sink sink)
+    : m_sink(std::move(sink))
+{
+}
+
+void StreamParser::reset(){
+    m_state = State::Idle;
+    m_consumed = 0;
+    m_textBegin = 0;
+    m_buffered = false;
+    m_token.clear();
+    m_ops.clear();
+    m_error = HexError();
+    m_errorText.clear();
+    m_deferred = HexError();
+}
+
+void StreamParser::emit(const Item &item){
+    if (m_deferred.code == HexErrorCode::None) m_sink(item);
+}
+
+bool StreamParser::fail(HexError &err, HexErrorCode code, std::size_t offset, std::size_t length, std::string_view text){
+    m_error = { code, offset, length };
+    m_errorText.assign(text.data(), text.size());
+    err = m_error;
+    return false;
+}
+
+void StreamParser::formatError(const HexError &err, std::string &out) const{
+    // 只保存了出错 token 本身, 位置换算到这段文字上
+    HexError local = err;
+    local.offset = 0;
+    local.length = std::min(err.length, m_errorText.size());
+    HexEngine::formatError(local, m_errorText, out);
+}
+
+std::string_view StreamParser::tokenText(std::string_view chunk, std::size_t end){
+    if (!m_buffered) return chunk.substr(m_textBegin, end - m_textBegin);
+    // 跨块的 token 补上本块的部分; Word 转成 Number 后还会继续追加
+    m_token.append(chunk.data() + m_textBegin, end - m_textBegin);
+    m_textBegin = end;
+    return m_token;
+}
+
+void StreamParser::endToken(){
+    m_state = State::Idle;
+    m_buffered = false;
+    m_token.clear();
+}
+
+void StreamParser::operand(ItemType type, std::string_view text, std::size_t offset, std::size_t length){
+    emit({type, text, offset, length});
+    while (!m_ops.empty() && m_ops.back().type == ItemType::UnaryPreOp){
+        emit(m_ops.back());
+        m_ops.pop_back();
+    }
+}
+
+void StreamParser::pushOp(ItemType type, std::string_view text, std::size_t offset, std::size_t length){
+    if (type == ItemType::Op){
+        const int p1 = operatorPrecedence(text);
+        const bool left = isLeftAssociative(text);
+        while (!m_ops.empty()){
+            const Item &top = m_ops.back();
+            if (top.type != ItemType::Op || isParen(top)) break;
+
+            const int p2 = operatorPrecedence(top.text);
+            if ((left && p1 <= p2) || (!left && p1 < p2)){
+                emit(top);
+                m_ops.pop_back();
+            } else {
+                break;
+            }
+        }
+    }
+    m_ops.push_back({type, text, offset, length});
+}
+
+void StreamParser::closeParen(std::size_t offset){
+    for (;;){
+        if (m_ops.empty()){
+            // HexEngine 先分完词再匹配括号, 后面的词法错误优先; 先记下, 到 finish() 再报告
+            if (m_deferred.code == HexErrorCode::None) m_deferred = { HexErrorCode::MismatchedParentheses, offset, 1 };
+            return;
+        }
+        const Item top = m_ops.back();
+        m_ops.pop_back();
+        if (isParen(top)) break;
+        emit(top);
+    }
+    // 括号整体是前缀运算符的操作数
+    while (!m_ops.empty() && m_ops.back().type == ItemType::UnaryPreOp){
+        emit(m_ops.back());
+        m_ops.pop_back();
+    }
+}
+
+bool StreamParser::endWord(std::string_view word, char next){
+    // 与 tokenize() 相同: 关键字优先, 其次是十六进制数, 剩下的是变量
+    KeywordKind kind;
+    std::string_view name = findKeyword(word, kind);
+    if (kind != KeywordKind::None){
+        pushOp(kind == KeywordKind::Binary ? ItemType::Op : ItemType::UnaryPreOp, name, m_tokenOffset, word.size());
+        return false;
+    }
+    if (!isHexDigit(word.front())){
+        operand(ItemType::Variable, word, m_tokenOffset, word.size());
+        return false;
+    }
+
+    std::size_t p = 0;
+    while (p < word.size() && isHexDigit(word[p])) p++;
+    if (p == word.size()){
+        // 整个都是十六进制数字, 后面的小数点属于同一个数
+        if (next == '.') return true;
+        operand(ItemType::Number, word, m_tokenOffset, word.size());
+        return false;
+    }
+
+    // ABGH -> 数 AB, 标识符 GH (也可能是关键字, 如 FFROL)
+    operand(ItemType::Number, word.substr(0, p), m_tokenOffset, p);
+    const std::string_view rest = word.substr(p);
+    name = findKeyword(rest, kind);
+    if (kind != KeywordKind::None) pushOp(kind == KeywordKind::Binary ? ItemType::Op : ItemType::UnaryPreOp, name, m_tokenOffset + p, rest.size());
+    else operand(ItemType::Variable, rest, m_tokenOffset + p, rest.size());
+    return false;
+}
+
+bool StreamParser::endNumber(std::string_view text, HexError &err){
+    if (text == ".") return fail(err, HexErrorCode::InvalidNumber, m_tokenOffset, 1, text);
+    operand(ItemType::Number, text, m_tokenOffset, text.size());
+    return true;
+}
+
+bool StreamParser::step(std::string_view chunk, std::size_t &i, HexError &err){
+    const std::size_t size = chunk.size();
+    const std::size_t pos = m_consumed + i;
+
+    switch (m_state){
+    case State::Word: {
+        std::size_t j = i;
+        while (j < size && isWordChar(chunk[j])) j++;
+        i = j;
+        if (j == size) return true;
+
+        if (endWord(tokenText(chunk, j), chunk[j])){
+            m_state = State::Number;
+            m_seenDot = true;
+            i++;
+        } else {
+            endToken();
+        }
+        return true;
+    }
+    case State::Number: {
+        std::size_t j = i;
+        for (;;){
+            j += hexRunLength(chunk.data() + j, size - j);
+            if (j < size && chunk[j] == '.' && !m_seenDot){
+                m_seenDot = true;
+                j++;
+                continue;
+            }
+            break;
+        }
+        i = j;
+        if (j == size) return true;
+
+        if (!endNumber(tokenText(chunk, j), err)) return false;
+        endToken();
+        return true;
+    }
+    case State::Bytes: {
+        const std::size_t j = i + hexRunLength(chunk.data() + i, size - i);
+        i = j;
+        if (j == size) return true;
+
+        const std::string_view text = tokenText(chunk, j);
+        if (text.empty()) return fail(err, HexErrorCode::EmptyByteLiteral, m_tokenOffset, 1);
+        operand(ItemType::Bytes, text, m_tokenOffset, text.size() + 1);
+        endToken();
+        return true;
+    }
+    case State::File: {
+        const void *quote = std::memchr(chunk.data() + i, '"', size - i);
+        if (!quote){
+            i = size;
+            return true;
+        }
+        const std::size_t j = static_cast<std::size_t>(static_cast<const char *>(quote) - chunk.data());
+        const std::string_view text = tokenText(chunk, j);
+        operand(ItemType::File, text, m_tokenOffset + 1, text.size());
+        endToken();
+        i = j + 1;
+        return true;
+    }
+    case State::Pair: {
+        const char c = chunk[i];
+        if (isExprSpace(c)){
+            i++;
+            return true;
+        }
+        if (c == m_pairChar){
+            pushOp(ItemType::Op, c == '^' ? "^^" : c == '<' ? "<<" : ">>", m_tokenOffset, pos + 1 - m_tokenOffset);
+            m_state = State::Idle;
+            i++;
+            return true;
+        }
+        if (m_pairChar != '^') return fail(err, HexErrorCode::InvalidOperator, m_tokenOffset, 1, std::string_view(&m_pairChar, 1));
+        // 单独的 ^, 当前字符重新按空闲状态处理
+        pushOp(ItemType::Op, "^", m_tokenOffset, 1);
+        m_state = State::Idle;
+        return true;
+    }
+    case State::BadChar: {
+        const std::size_t n = std::min(m_charLength - m_token.size(), size - i);
+        m_token.append(chunk.data() + i, n);
+        i += n;
+        if (m_token.size() < m_charLength) return true;
+        return fail(err, HexErrorCode::UnexpectedChar, m_tokenOffset, m_token.size(), m_token);
+    }
+    case State::Idle:
+        break;
+    }
+
+    const char c = chunk[i];
+    if (isExprSpace(c)){
+        i++;
+        return true;
+    }
+
+    switch (c){
+    case '(':
+        m_ops.push_back({ItemType::Op, "(", pos, 1});
+        i++;
+        return true;
+    case ')':
+        i++;
+        closeParen(pos);
+        return true;
+    case '!':
+        emit({ItemType::UnaryPostOp, "!", pos, 1});
+        i++;
+        return true;
+    case '~':
+        pushOp(ItemType::UnaryPreOp, "~", pos, 1);
+        i++;
+        return true;
+    case '#':
+    case '"':
+        m_state = c == '#' ? State::Bytes : State::File;
+        m_tokenOffset = pos;
+        m_textBegin = i + 1;
+        i++;
+        return true;
+    case '^':
+    case '<':
+    case '>':
+        m_state = State::Pair;
+        m_pairChar = c;
+        m_tokenOffset = pos;
+        i++;
+        return true;
+    default:
+        break;
+    }
+
+    const std::size_t single = kSingleOps.find(c);
+    if (single != std::string_view::npos){
+        pushOp(ItemType::Op, kSingleOps.substr(single, 1), pos, 1);
+        i++;
+        return true;
+    }
+    if ((c >= 'A' && c <= 'Z') || c == '_' || isHexDigit(c) || c == '.'){
+        m_state = (c >= '0' && c <= '9') || c == '.' ? State::Number : State::Word;
+        m_seenDot = c == '.';
+        m_tokenOffset = pos;
+        m_textBegin = i;
+        i++;
+        return true;
+    }
+
+    // 非 ASCII 字符按整个 UTF-8 序列报错
+    const unsigned char u = static_cast<unsigned char>(c);
+    const std::size_t len = u >= 0xF0 ? 4 : u >= 0xE0 ? 3 : u >= 0xC0 ? 2 : 1;
+    if (i + len <= size) return fail(err, HexErrorCode::UnexpectedChar, pos, len, chunk.substr(i, len));
+    m_state = State::BadChar;
+    m_charLength = len;
+    m_tokenOffset = pos;
+    m_token.assign(chunk.data() + i, size - i);
+    i = size;
+    return true;
+}
+
+bool StreamParser::feed(std::string_view chunk, HexError &err){
+    if (m_error.code != HexErrorCode::None){
+        err = m_error;
+        return false;
+    }
+
+    if (m_buffered) m_textBegin = 0;
+    std::size_t i = 0;
+    while (i < chunk.size()){
+        if (!step(chunk, i, err)) return false;
+    }
+
+    // 块结束时还没结束的 token 复制一份, 下一块接着拼
+    if (m_state == State::Word || m_state == State::Number || m_state == State::Bytes || m_state == State::File){
+        if (!m_buffered){
+            m_token.assign(chunk.data() + m_textBegin, chunk.size() - m_textBegin);
+            m_buffered = true;
+        } else {
+            m_token.append(chunk.data() + m_textBegin, chunk.size() - m_textBegin);
+        }
+    }
+    m_consumed += chunk.size();
+    return true;
+}
+
+bool StreamParser::finish(HexError &err){
+    if (m_error.code != HexErrorCode::None){
+        err = m_error;
+        return false;
+    }
+
+    // 未结束的 token 必然已经在 m_token 中
+    switch (m_state){
+    case State::Idle:
+        break;
+    case State::Word:
+        endWord(m_token, '\0');
+        break;
+    case State::Number:
+        if (!endNumber(m_token, err)) return false;
+        break;
+    case State::Bytes:
+        if (m_token.empty()) return fail(err, HexErrorCode::EmptyByteLiteral, m_tokenOffset, 1);
+        operand(ItemType::Bytes, m_token, m_tokenOffset, m_token.size() + 1);
+        break;
+    case State::File:
+        return fail(err, HexErrorCode::UnterminatedFileName, m_tokenOffset, m_consumed - m_tokenOffset);
+    case State::Pair:
+        if (m_pairChar != '^') return fail(err, HexErrorCode::InvalidOperator, m_tokenOffset, 1, std::string_view(&m_pairChar, 1));
+        pushOp(ItemType::Op, "^", m_tokenOffset, 1);
+        break;
+    case State::BadChar:
+        return fail(err, HexErrorCode::UnexpectedChar, m_tokenOffset, m_token.size(), m_token);
+    }
+    endToken();
+
+    if (m_consumed == 0) return fail(err, HexErrorCode::EmptyExpression, 0, 0);
+    if (m_deferred.code != HexErrorCode::None) return fail(err, m_deferred.code, m_deferred.offset, m_deferred.length, ")");
+
+    while (!m_ops.empty()){
+        const Item top = m_ops.back();
+        m_ops.pop_back();
+        if (isParen(top)) return fail(err, HexErrorCode::MismatchedParentheses, top.offset, 1, "(");
+        emit(top);
+    }
+
+    reset();
+    return true;
+}
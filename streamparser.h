@@ -0,0 +1,97 @@
+#ifndef STREAMPARSER_H
+#define STREAMPARSER_H
+
+#include "hexerror.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 推送式解析器: 表达式分块送入, 边分词边做调度场, 逆波兰 token 逐个交给 sink
+// 块边界可以落在任意位置, 包括数字 / 关键字 / "<<" / "^ ^" 的中间
+// 词法和优先级规则与 HexEngine 相同, 输出的 token 序列也相同
+// 只保留运算符栈和当前未结束的一个 token, 内存随括号嵌套深度增长, 与输入总长度无关
+// (连续的前缀运算符 / 右结合的 ^ 同样会留在栈上)
+// 错误码和位置与 HexEngine 相同: 词法错误在 feed() 中按出现的先后报告,
+// 多余的 ")" 要等到 finish() 才报告, 因为它后面的词法错误优先; 出错前已经输出的 token 应当丢弃
+class StreamParser
+{
+public:
+    enum class ItemType {
+        Number,
+        Bytes,          // text 不含 '#'
+        File,           // text 不含引号
+        Variable,
+        Op,
+        UnaryPreOp,
+        UnaryPostOp
+    };
+
+    // text 只在回调期间有效, 需要保留时由调用方复制
+    // [offset, offset + length) 是 token 在整个输入中的字节位置
+    struct Item {
+        ItemType type;
+        std::string_view text;
+        std::size_t offset;
+        std::size_t length;
+    };
+    using Sink = std::function<void(const Item &)>;
+
+    explicit StreamParser(Sink sink);
+
+    // 出错后不再接受输入, 直到 reset()
+    bool feed(std::string_view chunk, HexError &err);
+    // 输入结束, 输出最后一个 token 和栈中剩余的运算符; 成功后可以直接送入下一个表达式
+    bool finish(HexError &err);
+    void reset();
+
+    // 已送入的字节数
+    std::size_t consumed() const { return m_consumed; }
+
+    // 出错 token 的文字由解析器保存, 渲染错误信息不需要完整输入
+    void formatError(const HexError &err, std::string &out) const;
+
+private:
+    enum class State {
+        Idle,
+        Word,       // 标识符 / 关键字 / 十六进制字母开头的数, 到结尾才能区分
+        Number,
+        Bytes,
+        File,
+        Pair,       // 已读到 ^ < >, 等待 (跳过空白后的) 第二个字符
+        BadChar     // 非法的 UTF-8 字符被块边界截断, 收齐后报错
+    };
+
+    bool step(std::string_view chunk, std::size_t &i, HexError &err);
+    bool endWord(std::string_view word, char next);
+    bool endNumber(std::string_view text, HexError &err);
+    std::string_view tokenText(std::string_view chunk, std::size_t end);
+    void endToken();
+    // 已有推迟报告的错误时不再输出
+    void emit(const Item &item);
+    void operand(ItemType type, std::string_view text, std::size_t offset, std::size_t length);
+    void pushOp(ItemType type, std::string_view text, std::size_t offset, std::size_t length);
+    void closeParen(std::size_t offset);
+    bool fail(HexError &err, HexErrorCode code, std::size_t offset, std::size_t length, std::string_view text = std::string_view());
+
+    Sink m_sink;
+    State m_state = State::Idle;
+    std::size_t m_consumed = 0;
+    // 当前 token: 起点 (用于报错) / 文字在本块中的起点 / 跨块时已缓存的部分
+    std::size_t m_tokenOffset = 0;
+    std::size_t m_textBegin = 0;
+    bool m_buffered = false;
+    std::string m_token;
+    bool m_seenDot = false;
+    char m_pairChar = 0;
+    std::size_t m_charLength = 0;
+    // 运算符栈, text 指向静态字符串, "(" 也放在这里
+    std::vector<Item> m_ops;
+    HexError m_error;
+    std::string m_errorText;
+    // 多余的 ")", 在 finish() 中报告
+    HexError m_deferred;
+};
+
+#endif // STREAMPARSER_H